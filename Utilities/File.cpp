@@ -1411,6 +1411,68 @@ fs::native_handle fs::file::get_handle() const
 #endif
 }
 
+u64 fs::file::try_read_native(void* buffer, u64 count) const
+{
+	const native_handle handle = get_handle();
+
+#ifdef _WIN32
+	LARGE_INTEGER pos{};
+	DWORD nread;
+
+	if (handle == INVALID_HANDLE_VALUE || count > 0xffff'ffff || !SetFilePointerEx(handle, {}, &pos, FILE_CURRENT))
+	{
+		return -1;
+	}
+
+	if (!ReadFile(handle, buffer, static_cast<DWORD>(count), &nread, nullptr))
+	{
+		// The position is unspecified after a failure
+		SetFilePointerEx(handle, pos, nullptr, FILE_BEGIN);
+		return -1;
+	}
+
+	return nread;
+#else
+	if (handle == -1)
+	{
+		return -1;
+	}
+
+	return ::read(handle, buffer, count);
+#endif
+}
+
+u64 fs::file::try_write_native(const void* buffer, u64 count) const
+{
+	const native_handle handle = get_handle();
+
+#ifdef _WIN32
+	LARGE_INTEGER pos{};
+	DWORD nwritten;
+
+	if (handle == INVALID_HANDLE_VALUE || count > 0xffff'ffff || !SetFilePointerEx(handle, {}, &pos, FILE_CURRENT))
+	{
+		return -1;
+	}
+
+	if (!WriteFile(handle, buffer, static_cast<DWORD>(count), &nwritten, nullptr))
+	{
+		// The position is unspecified after a failure
+		SetFilePointerEx(handle, pos, nullptr, FILE_BEGIN);
+		return -1;
+	}
+
+	return nwritten;
+#else
+	if (handle == -1)
+	{
+		return -1;
+	}
+
+	return ::write(handle, buffer, count);
+#endif
+}
+
 bool fs::dir::open(const std::string& path)
 {
 	if (path.empty())
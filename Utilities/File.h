@@ -487,6 +487,11 @@ namespace fs
 		// Get native handle if available
 		native_handle get_handle() const;
 
+		// Read or write through the native handle at the current position without asserting on failure (e.g. inaccessible buffer)
+		// Returns -1 on error or if the native handle is not available
+		u64 try_read_native(void* buffer, u64 count) const;
+		u64 try_write_native(const void* buffer, u64 count) const;
+
 		// Gathered write
 		u64 write_gather(const iovec_clone* buffers, u64 buf_count,
 			u32 line = __builtin_LINE(),
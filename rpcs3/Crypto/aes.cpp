@@ -758,6 +758,12 @@ int aes_crypt_cbc( aes_context *ctx,
     if( length % 16 )
         return( POLARSSL_ERR_AES_INVALID_INPUT_LENGTH );
 
+    if( mode == AES_DECRYPT && aesni_supports( POLARSSL_AESNI_AES ) )
+    {
+        aesni_crypt_cbc_decrypt( ctx, length, iv, input, output );
+        return( 0 );
+    }
+
     if( mode == AES_DECRYPT )
     {
         while( length > 0 )
@@ -33,6 +33,10 @@
 #if defined(_MSC_VER) && defined(_M_X64)
 #define POLARSSL_HAVE_MSVC_X64_INTRINSICS
 #include <intrin.h>
+#define POLARSSL_AESNI_FUNC
+#else
+#include <immintrin.h>
+#define POLARSSL_AESNI_FUNC __attribute__((__target__("aes,ssse3")))
 #endif
 
 /*
@@ -129,6 +133,114 @@ int aesni_crypt_ecb( aes_context *ctx,
     return( 0 );
 }
 
+/*
+ * AES-NI AES-CTR keystream (big-endian 128-bit counter) XORed into data,
+ * several blocks are processed at once to hide the latency of AESENC
+ */
+POLARSSL_AESNI_FUNC
+void aesni_crypt_ctr_xor( aes_context *ctx,
+                          const unsigned char counter[16],
+                          size_t blocks,
+                          unsigned char *data )
+{
+    const __m128i* rk = reinterpret_cast<const __m128i*>( ctx->rk );
+    const __m128i bswap = _mm_set_epi8( 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 );
+    const int nr = ctx->nr;
+
+    // Counter as a native 128-bit integer
+    const __m128i c = _mm_shuffle_epi8( _mm_loadu_si128( reinterpret_cast<const __m128i*>( counter ) ), bswap );
+    unsigned long long lo = _mm_cvtsi128_si64( c );
+    unsigned long long hi = _mm_cvtsi128_si64( _mm_unpackhi_epi64( c, c ) );
+
+    const __m128i rk0 = _mm_loadu_si128( rk );
+
+    while( blocks )
+    {
+        const size_t count = blocks < 8 ? blocks : 8;
+        __m128i b[8];
+
+        for( size_t j = 0; j < count; j++ )
+        {
+            b[j] = _mm_xor_si128( _mm_shuffle_epi8( _mm_set_epi64x( hi, lo ), bswap ), rk0 );
+
+            if( ++lo == 0 )
+                ++hi;
+        }
+
+        for( int r = 1; r < nr; r++ )
+        {
+            const __m128i k = _mm_loadu_si128( rk + r );
+
+            for( size_t j = 0; j < count; j++ )
+                b[j] = _mm_aesenc_si128( b[j], k );
+        }
+
+        const __m128i k = _mm_loadu_si128( rk + nr );
+
+        for( size_t j = 0; j < count; j++ )
+        {
+            __m128i* p = reinterpret_cast<__m128i*>( data ) + j;
+            _mm_storeu_si128( p, _mm_xor_si128( _mm_loadu_si128( p ), _mm_aesenclast_si128( b[j], k ) ) );
+        }
+
+        data += count * 16;
+        blocks -= count;
+    }
+}
+
+/*
+ * AES-NI AES-CBC decryption, blocks are independent so several are processed at once
+ */
+POLARSSL_AESNI_FUNC
+void aesni_crypt_cbc_decrypt( aes_context *ctx,
+                              size_t length,
+                              unsigned char iv[16],
+                              const unsigned char *input,
+                              unsigned char *output )
+{
+    const __m128i* rk = reinterpret_cast<const __m128i*>( ctx->rk );
+    const int nr = ctx->nr;
+
+    const __m128i rk0 = _mm_loadu_si128( rk );
+    __m128i prev = _mm_loadu_si128( reinterpret_cast<const __m128i*>( iv ) );
+
+    for( size_t blocks = length / 16; blocks; )
+    {
+        const size_t count = blocks < 8 ? blocks : 8;
+        __m128i c[8];
+        __m128i b[8];
+
+        // Load all ciphertext blocks first (in-place operation)
+        for( size_t j = 0; j < count; j++ )
+        {
+            c[j] = _mm_loadu_si128( reinterpret_cast<const __m128i*>( input ) + j );
+            b[j] = _mm_xor_si128( c[j], rk0 );
+        }
+
+        for( int r = 1; r < nr; r++ )
+        {
+            const __m128i k = _mm_loadu_si128( rk + r );
+
+            for( size_t j = 0; j < count; j++ )
+                b[j] = _mm_aesdec_si128( b[j], k );
+        }
+
+        const __m128i k = _mm_loadu_si128( rk + nr );
+
+        for( size_t j = 0; j < count; j++ )
+        {
+            _mm_storeu_si128( reinterpret_cast<__m128i*>( output ) + j, _mm_xor_si128( _mm_aesdeclast_si128( b[j], k ), prev ) );
+            prev = c[j];
+        }
+
+        input += count * 16;
+        output += count * 16;
+        blocks -= count;
+    }
+
+    _mm_storeu_si128( reinterpret_cast<__m128i*>( iv ), prev );
+}
+
 #if defined(POLARSSL_HAVE_MSVC_X64_INTRINSICS)
 static inline void clmul256( __m128i a, __m128i b, __m128i* r0, __m128i* r1 )
 {
@@ -61,6 +61,34 @@ int aesni_crypt_ecb( aes_context *ctx,
                      const unsigned char input[16],
                      unsigned char output[16] );
 
+/**
+ * \brief          AES-NI AES-CTR en(de)cryption in place
+ *
+ * \param ctx      AES context (encryption key schedule)
+ * \param counter  16-byte big-endian counter of the first block
+ * \param blocks   Number of 16-byte blocks
+ * \param data     Data to XOR with the keystream
+ */
+void aesni_crypt_ctr_xor( aes_context *ctx,
+                          const unsigned char counter[16],
+                          size_t blocks,
+                          unsigned char *data );
+
+/**
+ * \brief          AES-NI AES-CBC decryption
+ *
+ * \param ctx      AES context (decryption key schedule)
+ * \param length   Length of the input data (multiple of 16)
+ * \param iv       Initialization vector (updated after use)
+ * \param input    Buffer holding the input data
+ * \param output   Buffer holding the output data (can be the same as input)
+ */
+void aesni_crypt_cbc_decrypt( aes_context *ctx,
+                              size_t length,
+                              unsigned char iv[16],
+                              const unsigned char *input,
+                              unsigned char *output );
+
 /**
  * \brief          GCM multiplication: c = a * b in GF(2^128)
  *
@@ -6,6 +6,8 @@
 #include "ec.h"
 
 #include "Utilities/mutex.h"
+#include "Utilities/Thread.h"
+#include "util/sysinfo.hpp"
 #include <cmath>
 
 #include "util/asm.hpp"
@@ -961,6 +963,135 @@ bool EDATADecrypter::ReadHeader()
 	return true;
 }
 
+// Thread-safe view of the EDATA file with its own position, for parallel block decryption
+struct edata_shared_view final : fs::file_base
+{
+	const fs::file& m_file;
+	shared_mutex& m_mutex;
+	u64 m_pos = 0;
+
+	edata_shared_view(const fs::file& file, shared_mutex& mutex)
+		: m_file(file)
+		, m_mutex(mutex)
+	{
+	}
+
+	bool trunc(u64) override
+	{
+		return false;
+	}
+
+	u64 read(void* buffer, u64 size) override
+	{
+		std::lock_guard lock(m_mutex);
+
+		if (m_file.seek(m_pos) != m_pos)
+		{
+			return 0;
+		}
+
+		const u64 result = m_file.read(buffer, size);
+		m_pos += result;
+		return result;
+	}
+
+	u64 write(const void*, u64) override
+	{
+		return 0;
+	}
+
+	u64 seek(s64 offset, fs::seek_mode whence) override
+	{
+		const s64 new_pos =
+			whence == fs::seek_set ? offset :
+			whence == fs::seek_cur ? offset + m_pos :
+			whence == fs::seek_end ? offset + size() : -1;
+
+		if (new_pos < 0)
+		{
+			fs::g_tls_error = fs::error::inval;
+			return -1;
+		}
+
+		m_pos = new_pos;
+		return m_pos;
+	}
+
+	u64 size() override
+	{
+		std::lock_guard lock(m_mutex);
+		return m_file.size();
+	}
+};
+
+bool EDATADecrypter::DecryptBlocks(const std::vector<u32>& blocks, std::vector<cached_block>& out)
+{
+	out.resize(blocks.size());
+
+	const auto decrypt_one = [&](const fs::file& file, usz i)
+	{
+		auto& block = out[i];
+		block.index = blocks[i];
+		block.data.reset(new u8[edatHeader.block_size]);
+
+		file.seek(0);
+		const s64 res = decrypt_block(&file, block.data.get(), &edatHeader, &npdHeader, reinterpret_cast<uchar*>(&dec_key), blocks[i], total_blocks, edatHeader.file_size);
+
+		if (res < 0)
+		{
+			return false;
+		}
+
+		block.size = res;
+		return true;
+	};
+
+	// The first block is decrypted on this thread (also initializes the crypto tables)
+	if (!decrypt_one(edata_file, 0))
+	{
+		return false;
+	}
+
+	// Creating threads only pays off for large reads, give each worker at least 16 blocks
+	const u32 worker_count = std::min<u32>(utils::get_thread_count(), ::size32(blocks) / 16);
+
+	if (worker_count <= 2)
+	{
+		for (usz i = 1; i < blocks.size(); i++)
+		{
+			if (!decrypt_one(edata_file, i))
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	// Reading is serialized, decryption and hashing run in parallel
+	shared_mutex file_mutex;
+	atomic_t<usz> next = 1;
+	atomic_t<bool> failed = false;
+
+	named_thread_group workers("EDAT Decrypter "sv, worker_count, [&]()
+	{
+		fs::file view;
+		view.reset(std::make_unique<edata_shared_view>(edata_file, file_mutex));
+
+		for (usz i = next++; i < blocks.size() && !failed; i = next++)
+		{
+			if (!decrypt_one(view, i))
+			{
+				failed = true;
+			}
+		}
+	});
+
+	workers.join();
+
+	return !failed;
+}
+
 u64 EDATADecrypter::ReadData(u64 pos, u8* data, u64 size)
 {
 	if (pos > edatHeader.file_size)
@@ -969,32 +1100,91 @@ u64 EDATADecrypter::ReadData(u64 pos, u8* data, u64 size)
 	// now we need to offset things to account for the actual 'range' requested
 	const u64 startOffset = pos % edatHeader.block_size;
 
+	// find and decrypt block range covering pos + size
+	const u32 starting_block = static_cast<u32>(pos / edatHeader.block_size);
 	const u32 num_blocks = static_cast<u32>(utils::aligned_div(startOffset + size, edatHeader.block_size));
-	const u64 bufSize = num_blocks*edatHeader.block_size;
-	if (data_buf_size < (bufSize))
+	const u32 ending_block = std::min(starting_block + num_blocks, total_blocks);
+
+	if (starting_block >= ending_block)
+		return 0;
+
+	if (block_cache.empty())
 	{
-		data_buf.reset(new u8[bufSize]);
-		data_buf_size = bufSize;
+		// Keep about 2 MB of decrypted data
+		block_cache.resize(std::max<u32>(16, 0x200000 / edatHeader.block_size));
 	}
 
-	// find and decrypt block range covering pos + size
-	const u32 starting_block = static_cast<u32>(pos / edatHeader.block_size);
-	const u32 ending_block = std::min(starting_block + num_blocks, total_blocks);
-	u64 writeOffset = 0;
+	// Look up cached blocks
+	std::vector<const cached_block*> range(ending_block - starting_block);
+	std::vector<u32> missing;
+
 	for (u32 i = starting_block; i < ending_block; ++i)
 	{
-		edata_file.seek(0);
-		u64 res = decrypt_block(&edata_file, &data_buf[writeOffset], &edatHeader, &npdHeader, reinterpret_cast<uchar*>(&dec_key), i, total_blocks, edatHeader.file_size);
-		if (res == umax)
+		for (auto& block : block_cache)
 		{
-			edat_log.error("Error Decrypting data");
-			return 0;
+			if (block.index == i && block.data)
+			{
+				block.last_use = ++cache_tick;
+				range[i - starting_block] = &block;
+				break;
+			}
 		}
-		writeOffset += res;
+
+		if (!range[i - starting_block])
+		{
+			missing.push_back(i);
+		}
+	}
+
+	std::vector<cached_block> decrypted;
+
+	if (!missing.empty() && !DecryptBlocks(missing, decrypted))
+	{
+		edat_log.error("Error Decrypting data");
+		return 0;
+	}
+
+	for (auto& block : decrypted)
+	{
+		range[block.index - starting_block] = &block;
 	}
 
-	const u64 bytesWrote = std::min<u64>(writeOffset - startOffset, size);
+	// Copy the requested range
+	u64 bytesWrote = 0;
+	u64 skip = startOffset;
+
+	for (const cached_block* block : range)
+	{
+		if (skip >= block->size)
+		{
+			skip -= block->size;
+			continue;
+		}
+
+		const u64 count = std::min<u64>(block->size - skip, size - bytesWrote);
+		std::memcpy(data + bytesWrote, block->data.get() + skip, count);
+		bytesWrote += count;
+		skip = 0;
+
+		if (bytesWrote == size)
+		{
+			break;
+		}
+	}
+
+	// Store new blocks, replacing the least recently used ones (only the last blocks of large reads are kept)
+	const usz keep = std::min<usz>(decrypted.size(), block_cache.size());
+
+	for (usz i = decrypted.size() - keep; i < decrypted.size(); i++)
+	{
+		auto& slot = *std::min_element(block_cache.begin(), block_cache.end(), [](const cached_block& a, const cached_block& b)
+		{
+			return a.last_use < b.last_use;
+		});
+
+		slot = std::move(decrypted[i]);
+		slot.last_use = ++cache_tick;
+	}
 
-	memcpy(data, &data_buf[startOffset], bytesWrote);
 	return bytesWrote;
 }
@@ -60,9 +60,17 @@ struct EDATADecrypter final : fs::file_base
 	NPD_HEADER npdHeader{};
 	EDAT_HEADER edatHeader{};
 
-	// Internal data buffers.
-	std::unique_ptr<u8[]> data_buf{};
-	u64 data_buf_size{0};
+	// Recently decrypted blocks (LRU)
+	struct cached_block
+	{
+		u32 index = -1;
+		u64 last_use = 0;
+		u64 size = 0;
+		std::unique_ptr<u8[]> data;
+	};
+
+	std::vector<cached_block> block_cache{};
+	u64 cache_tick{0};
 
 	u128 dec_key{};
 
@@ -84,6 +92,12 @@ public:
 	bool ReadHeader();
 	u64 ReadData(u64 pos, u8* data, u64 size);
 
+private:
+	// Decrypt blocks which are not cached, several blocks are decrypted in parallel
+	bool DecryptBlocks(const std::vector<u32>& blocks, std::vector<cached_block>& out);
+
+public:
+
 	fs::stat_t stat() override
 	{
 		fs::stat_t stats;
@@ -1,5 +1,6 @@
 #include "stdafx.h"
 #include "aes.h"
+#include "aesni.h"
 #include "sha1.h"
 #include "key_vault.h"
 #include "util/logs.hpp"
@@ -8,6 +9,9 @@
 #include "Emu/VFS.h"
 #include "unpkg.h"
 #include "Loader/PSF.h"
+#include "Utilities/Thread.h"
+#include "util/sysinfo.hpp"
+#include "util/asm.hpp"
 
 LOG_CHANNEL(pkg_log, "PKG");
 
@@ -771,38 +775,31 @@ bool package_reader::extract_data(atomic_t<double>& sync)
 
 			if (fs::file out{ path, fs::rewrite })
 			{
-				bool extract_success = true;
-				for (u64 pos = 0; pos < entry.file_size; pos += BUF_SIZE)
-				{
-					const u64 block_size = std::min<u64>(BUF_SIZE, entry.file_size - pos);
-
-					if (decrypt(entry.file_offset + pos, block_size, is_psp ? PKG_AES_KEY2 : m_dec_key.data()) != block_size)
-					{
-						extract_success = false;
-						pkg_log.error("Failed to extract file %s", path);
-						break;
-					}
-
-					if (out.write(m_buf.get(), block_size) != block_size)
-					{
-						extract_success = false;
-						pkg_log.error("Failed to write file %s", path);
-						break;
-					}
+				bool cancelled = false;
 
+				const bool extract_success = extract_file(out, entry, is_psp ? PKG_AES_KEY2 : m_dec_key.data(), path, [&](u64 block_size)
+				{
 					if (sync.fetch_add((block_size + 0.0) / m_header.data_size) < 0.)
 					{
 						if (was_null)
 						{
-							pkg_log.error("Package installation cancelled: %s", dir);
-							out.close();
-							fs::remove_all(dir, true);
+							cancelled = true;
 							return false;
 						}
 
 						// Cannot cancel the installation
 						sync += 1.;
 					}
+
+					return true;
+				});
+
+				if (cancelled)
+				{
+					pkg_log.error("Package installation cancelled: %s", dir);
+					out.close();
+					fs::remove_all(dir, true);
+					return false;
 				}
 
 				if (extract_success)
@@ -945,8 +942,16 @@ u64 package_reader::decrypt(u64 offset, u64 size, const uchar* key)
 	// Read the data and set available size
 	const u64 read = archive_read(m_buf.get(), size);
 
-	// Get block count
-	const u64 blocks = (read + 15) / 16;
+	decrypt_block(offset, m_buf.get(), read, key);
+
+	// Return the amount of data written in buf
+	return read;
+}
+
+void package_reader::decrypt_block(u64 offset, u128* data, u64 size, const uchar* key) const
+{
+	// The stream cipher only depends on the position, so blocks can be decrypted independently
+	const u64 blocks = (size + 15) / 16;
 
 	if (m_header.pkg_type == PKG_RELEASE_TYPE_DEBUG)
 	{
@@ -972,7 +977,7 @@ u64 package_reader::decrypt(u64 offset, u64 size, const uchar* key)
 
 			sha1(reinterpret_cast<const u8*>(input), sizeof(input), hash.data);
 
-			m_buf[i] ^= hash._v128;
+			data[i] ^= hash._v128;
 		}
 	}
 	else if (m_header.pkg_type == PKG_RELEASE_TYPE_RELEASE)
@@ -985,6 +990,12 @@ u64 package_reader::decrypt(u64 offset, u64 size, const uchar* key)
 		// Initialize stream cipher for start position
 		be_t<u128> input = m_header.klicensee.value() + offset / 16;
 
+		if (aesni_supports(POLARSSL_AESNI_AES))
+		{
+			aesni_crypt_ctr_xor(&ctx, reinterpret_cast<const u8*>(&input), blocks, reinterpret_cast<u8*>(data));
+			return;
+		}
+
 		// Increment stream position for every block
 		for (u64 i = 0; i < blocks; i++, input++)
 		{
@@ -992,14 +1003,174 @@ u64 package_reader::decrypt(u64 offset, u64 size, const uchar* key)
 
 			aes_crypt_ecb(&ctx, AES_ENCRYPT, reinterpret_cast<const u8*>(&input), reinterpret_cast<u8*>(&key));
 
-			m_buf[i] ^= key;
+			data[i] ^= key;
 		}
 	}
 	else
 	{
 		pkg_log.error("Unknown release type (0x%x)", m_header.pkg_type);
 	}
+}
 
-	// Return the amount of data written in buf
-	return read;
-};
+bool package_reader::extract_file(fs::file& out, const PKGEntry& entry, const uchar* key, const std::string& path, const std::function<bool(u64)>& progress)
+{
+	const u64 file_size = entry.file_size;
+
+	if (file_size <= BUF_SIZE)
+	{
+		// Small file: not worth the threads
+		if (file_size && decrypt(entry.file_offset, file_size, key) != file_size)
+		{
+			pkg_log.error("Failed to extract file %s", path);
+			return false;
+		}
+
+		if (out.write(m_buf.get(), file_size) != file_size)
+		{
+			pkg_log.error("Failed to write file %s", path);
+			return false;
+		}
+
+		return progress(file_size);
+	}
+
+	// Pipeline: the reader thread does large sequential reads, decryption workers take chunks independently
+	// and this thread writes them in order, the chunk buffers are recycled through a ring of slots
+	const u64 chunk_count = utils::aligned_div<u64>(file_size, CHUNK_SIZE);
+	const u32 worker_count = static_cast<u32>(std::min<u64>(std::max<u32>(utils::get_thread_count(), 2) - 1, chunk_count));
+	const u32 slot_count = worker_count + 2;
+
+	struct chunk_slot
+	{
+		std::unique_ptr<u128[]> data;
+		u64 size = 0;
+
+		// Chunk index * 4 + stage (0: free, 1: read, 2: decrypted)
+		atomic_t<u64> state = 0;
+	};
+
+	static constexpr u64 aborted = -1;
+
+	const auto slots = std::make_unique<chunk_slot[]>(slot_count);
+
+	for (u32 i = 0; i < slot_count; i++)
+	{
+		slots[i].state.release(i * 4);
+	}
+
+	// Wait for the slot to reach the expected state, returns false if the extraction was aborted
+	const auto wait_state = [](chunk_slot& slot, u64 value)
+	{
+		for (u64 old = slot.state; old != value; old = slot.state)
+		{
+			if (old == aborted)
+			{
+				return false;
+			}
+
+			slot.state.wait(old);
+		}
+
+		return true;
+	};
+
+	named_thread reader("PKG Reader"sv, [&]()
+	{
+		archive_seek(m_header.data_offset + entry.file_offset);
+
+		for (u64 i = 0; i < chunk_count; i++)
+		{
+			auto& slot = slots[i % slot_count];
+
+			if (!wait_state(slot, i * 4))
+			{
+				return;
+			}
+
+			if (!slot.data)
+			{
+				slot.data.reset(new u128[CHUNK_SIZE / sizeof(u128)]);
+			}
+
+			// A short read is reported by the writer
+			slot.size = archive_read(slot.data.get(), std::min<u64>(CHUNK_SIZE, file_size - i * CHUNK_SIZE));
+
+			if (slot.state.compare_and_swap_test(i * 4, i * 4 + 1))
+			{
+				slot.state.notify_all();
+			}
+		}
+	});
+
+	atomic_t<u64> next_chunk = 0;
+
+	named_thread_group workers("PKG Decrypter "sv, worker_count, [&]()
+	{
+		for (u64 i = next_chunk++; i < chunk_count; i = next_chunk++)
+		{
+			auto& slot = slots[i % slot_count];
+
+			if (!wait_state(slot, i * 4 + 1))
+			{
+				return;
+			}
+
+			decrypt_block(entry.file_offset + i * CHUNK_SIZE, slot.data.get(), slot.size, key);
+
+			if (slot.state.compare_and_swap_test(i * 4 + 1, i * 4 + 2))
+			{
+				slot.state.notify_all();
+			}
+		}
+	});
+
+	bool success = true;
+
+	for (u64 i = 0; i < chunk_count; i++)
+	{
+		auto& slot = slots[i % slot_count];
+
+		// Only this thread can abort
+		ensure(wait_state(slot, i * 4 + 2));
+
+		const u64 block_size = std::min<u64>(CHUNK_SIZE, file_size - i * CHUNK_SIZE);
+
+		if (slot.size != block_size)
+		{
+			pkg_log.error("Failed to extract file %s", path);
+			success = false;
+			break;
+		}
+
+		if (out.write(slot.data.get(), block_size) != block_size)
+		{
+			pkg_log.error("Failed to write file %s", path);
+			success = false;
+			break;
+		}
+
+		if (!progress(block_size))
+		{
+			success = false;
+			break;
+		}
+
+		// Recycle the slot for the next chunk
+		slot.state.release((i + slot_count) * 4);
+		slot.state.notify_all();
+	}
+
+	if (!success)
+	{
+		for (u32 i = 0; i < slot_count; i++)
+		{
+			slots[i].state.release(aborted);
+			slots[i].state.notify_all();
+		}
+	}
+
+	workers.join();
+	reader();
+
+	return success;
+}
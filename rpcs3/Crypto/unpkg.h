@@ -6,6 +6,7 @@
 #include "Utilities/File.h"
 #include <sstream>
 #include <iomanip>
+#include <functional>
 
 // Constants
 enum
@@ -318,8 +319,11 @@ private:
 	void archive_seek(const s64 new_offset, const fs::seek_mode damode = fs::seek_set);
 	u64 archive_read(void* data_ptr, const u64 num_bytes);
 	u64 decrypt(u64 offset, u64 size, const uchar* key);
+	void decrypt_block(u64 offset, u128* data, u64 size, const uchar* key) const;
+	bool extract_file(fs::file& out, const PKGEntry& entry, const uchar* key, const std::string& path, const std::function<bool(u64)>& progress);
 
 	const usz BUF_SIZE = 8192 * 1024; // 8 MB
+	const usz CHUNK_SIZE = 2048 * 1024; // 2 MB, unit of work of the extraction pipeline
 
 	bool m_is_valid = false;
 
@@ -5,10 +5,30 @@
 #include "Emu/Cell/lv2/sys_process.h"
 #include "Emu/Cell/lv2/sys_event.h"
 #include "cellAudio.h"
+#include "Emu/perf_meter.hpp"
+
+#include "util/sysinfo.hpp"
 
 #include "emmintrin.h"
+#include "immintrin.h"
 #include <cmath>
 
+#if !defined(_MSC_VER) && defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wold-style-cast"
+#endif
+
+#if defined(_MSC_VER)
+#define SSSE3_FUNC
+#define AVX2_FUNC
+#else
+#define SSSE3_FUNC __attribute__((__target__("ssse3")))
+#define AVX2_FUNC __attribute__((__target__("avx2")))
+#endif // _MSC_VER
+
+const bool s_use_ssse3 = utils::has_ssse3();
+const bool s_use_avx2 = utils::has_avx2();
+
 LOG_CHANNEL(cellAudio);
 
 vm::gvar<char, AUDIO_PORT_OFFSET * AUDIO_PORT_COUNT> g_audio_buffer;
@@ -872,190 +892,297 @@ void cell_audio_thread::operator()()
 	ringbuffer.reset();
 }
 
-template <audio_downmix downmix>
-void cell_audio_thread::mix(float *out_buffer, s32 offset)
+namespace
 {
-	AUDIT(out_buffer != nullptr);
-
-	constexpr u32 channels = downmix == audio_downmix::no_downmix ? 8 : downmix == audio_downmix::downmix_to_5_1 ? 6 : 2;
-	constexpr u32 out_buffer_sz = channels * AUDIO_BUFFER_SAMPLES;
+	// Convert big-endian port samples to native floats scaled by the per-sample volume
+	template <u32 InCh>
+	void audio_decode_port_scalar(float* dst, const be_t<f32>* src, const float* volume)
+	{
+		for (u32 i = 0; i < AUDIO_BUFFER_SAMPLES; i++)
+		{
+			for (u32 c = 0; c < InCh; c++)
+			{
+				dst[i * InCh + c] = src[i * InCh + c] * volume[i];
+			}
+		}
+	}
 
-	bool first_mix = true;
+	template <u32 InCh>
+	SSSE3_FUNC void audio_decode_port_ssse3(float* dst, const be_t<f32>* src, const float* volume)
+	{
+		const __m128i bswap = _mm_set_epi8(12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3);
+		const auto in = reinterpret_cast<const __m128i*>(src);
 
-	const float master_volume = g_cfg.audio.volume / 100.0f;
+		if constexpr (InCh == 2)
+		{
+			for (u32 i = 0; i < AUDIO_BUFFER_SAMPLES; i += 2)
+			{
+				// Two frames per vector: volumes {v0, v0, v1, v1}
+				const __m128 v = _mm_castpd_ps(_mm_load_sd(reinterpret_cast<const double*>(volume + i)));
+				const __m128 x = _mm_castsi128_ps(_mm_shuffle_epi8(_mm_loadu_si128(in + i / 2), bswap));
+				_mm_store_ps(dst + i * 2, _mm_mul_ps(x, _mm_unpacklo_ps(v, v)));
+			}
+		}
+		else
+		{
+			for (u32 i = 0; i < AUDIO_BUFFER_SAMPLES; i++)
+			{
+				const __m128 v = _mm_set1_ps(volume[i]);
+				_mm_store_ps(dst + i * 8 + 0, _mm_mul_ps(_mm_castsi128_ps(_mm_shuffle_epi8(_mm_loadu_si128(in + i * 2 + 0), bswap)), v));
+				_mm_store_ps(dst + i * 8 + 4, _mm_mul_ps(_mm_castsi128_ps(_mm_shuffle_epi8(_mm_loadu_si128(in + i * 2 + 1), bswap)), v));
+			}
+		}
+	}
 
-	// mixing
-	for (auto& port : ports)
+	template <u32 InCh>
+	AVX2_FUNC void audio_decode_port_avx2(float* dst, const be_t<f32>* src, const float* volume)
 	{
-		if (port.state != audio_port_state::started) continue;
+		const __m256i bswap = _mm256_broadcastsi128_si256(_mm_set_epi8(12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3));
+		const auto in = reinterpret_cast<const __m256i*>(src);
 
-		auto buf = port.get_vm_ptr(offset);
+		if constexpr (InCh == 2)
+		{
+			const __m256i dup = _mm256_set_epi32(3, 3, 2, 2, 1, 1, 0, 0);
 
-		static constexpr float minus_3db = 0.707f; // value taken from https://www.dolby.com/us/en/technologies/a-guide-to-dolby-metadata.pdf
-		float m = master_volume;
+			for (u32 i = 0; i < AUDIO_BUFFER_SAMPLES; i += 4)
+			{
+				// Four frames per vector: volumes {v0, v0, v1, v1, v2, v2, v3, v3}
+				const __m256 v = _mm256_permutevar8x32_ps(_mm256_castps128_ps256(_mm_load_ps(volume + i)), dup);
+				const __m256 x = _mm256_castsi256_ps(_mm256_shuffle_epi8(_mm256_loadu_si256(in + i / 4), bswap));
+				_mm256_store_ps(dst + i * 2, _mm256_mul_ps(x, v));
+			}
+		}
+		else
+		{
+			for (u32 i = 0; i < AUDIO_BUFFER_SAMPLES; i++)
+			{
+				const __m256 x = _mm256_castsi256_ps(_mm256_shuffle_epi8(_mm256_loadu_si256(in + i), bswap));
+				_mm256_store_ps(dst + i * 8, _mm256_mul_ps(x, _mm256_set1_ps(volume[i])));
+			}
+		}
+	}
 
-		// part of cellAudioSetPortLevel functionality
-		// spread port volume changes over 13ms
-		auto step_volume = [master_volume, &m](audio_port& port)
+	template <u32 InCh>
+	void audio_decode_port(float* dst, const be_t<f32>* src, const float* volume)
+	{
+		if (s_use_avx2)
 		{
-			const auto param = port.level_set.load();
+			audio_decode_port_avx2<InCh>(dst, src, volume);
+		}
+		else if (s_use_ssse3)
+		{
+			audio_decode_port_ssse3<InCh>(dst, src, volume);
+		}
+		else
+		{
+			audio_decode_port_scalar<InCh>(dst, src, volume);
+		}
+	}
 
-			if (param.inc != 0.0f)
+	// Place decoded stereo frames into the output layout, the first port overwrites the buffer
+	template <u32 OutCh, bool First>
+	void audio_mix_stereo(float* out, const float* in)
+	{
+		if constexpr (OutCh == 2)
+		{
+			for (u32 i = 0; i < AUDIO_BUFFER_SAMPLES * 2; i += 4)
 			{
-				port.level += param.inc;
-				const bool dec = param.inc < 0.0f;
+				__m128 x = _mm_load_ps(in + i);
 
-				if ((!dec && param.value - port.level <= 0.0f) || (dec && param.value - port.level >= 0.0f))
+				if constexpr (!First)
 				{
-					port.level = param.value;
-					port.level_set.compare_and_swap(param, { param.value, 0.0f });
+					x = _mm_add_ps(x, _mm_load_ps(out + i));
 				}
-			}
 
-			m = port.level * master_volume;
-		};
-
-		if (port.num_channels == 2)
+				_mm_store_ps(out + i, x);
+			}
+		}
+		else
 		{
-			if (first_mix)
+			for (u32 i = 0; i < AUDIO_BUFFER_SAMPLES; i++)
 			{
-				for (u32 out = 0, in = 0; out < out_buffer_sz; out += channels, in += 2)
-				{
-					step_volume(port);
+				float* dst = out + i * OutCh;
 
-					const float left  = buf[in + 0] * m;
-					const float right = buf[in + 1] * m;
+				// {left, right, 0, 0}
+				const __m128 lr = _mm_castpd_ps(_mm_load_sd(reinterpret_cast<const double*>(in + i * 2)));
 
-					out_buffer[out + 0] = left;
-					out_buffer[out + 1] = right;
+				if constexpr (First)
+				{
+					_mm_storeu_ps(dst, lr);
 
-					if constexpr (downmix != audio_downmix::downmix_to_stereo)
+					if constexpr (OutCh == 8)
 					{
-						out_buffer[out + 2] = 0.0f;
-						out_buffer[out + 3] = 0.0f;
-						out_buffer[out + 4] = 0.0f;
-						out_buffer[out + 5] = 0.0f;
-
-						if constexpr (downmix != audio_downmix::downmix_to_5_1)
-						{
-							out_buffer[out + 6] = 0.0f;
-							out_buffer[out + 7] = 0.0f;
-						}
+						_mm_storeu_ps(dst + 4, _mm_setzero_ps());
+					}
+					else
+					{
+						_mm_storel_pi(reinterpret_cast<__m64*>(dst + 4), _mm_setzero_ps());
 					}
 				}
-				first_mix = false;
+				else
+				{
+					_mm_storel_pi(reinterpret_cast<__m64*>(dst), _mm_add_ps(lr, _mm_loadl_pi(_mm_setzero_ps(), reinterpret_cast<const __m64*>(dst))));
+				}
 			}
-			else
+		}
+	}
+
+	// Place decoded 7.1 frames into the output layout, downmixing if necessary
+	template <u32 OutCh, bool First>
+	void audio_mix_surround(float* out, const float* in)
+	{
+		if constexpr (OutCh == 8)
+		{
+			for (u32 i = 0; i < AUDIO_BUFFER_SAMPLES * 8; i += 4)
 			{
-				for (u32 out = 0, in = 0; out < out_buffer_sz; out += channels, in += 2)
+				__m128 x = _mm_load_ps(in + i);
+
+				if constexpr (!First)
 				{
-					step_volume(port);
+					x = _mm_add_ps(x, _mm_load_ps(out + i));
+				}
 
-					const float left  = buf[in + 0] * m;
-					const float right = buf[in + 1] * m;
+				_mm_store_ps(out + i, x);
+			}
+		}
+		else if constexpr (OutCh == 6)
+		{
+			for (u32 i = 0; i < AUDIO_BUFFER_SAMPLES; i++)
+			{
+				float* dst = out + i * 6;
+
+				// {left, right, center, low_freq}, {rear_left, rear_right, side_left, side_right}
+				__m128 front = _mm_load_ps(in + i * 8);
+				const __m128 back = _mm_load_ps(in + i * 8 + 4);
+
+				// {side_left + rear_left, side_right + rear_right}
+				__m128 sides = _mm_add_ps(_mm_movehl_ps(back, back), back);
 
-					out_buffer[out + 0] += left;
-					out_buffer[out + 1] += right;
+				if constexpr (!First)
+				{
+					front = _mm_add_ps(front, _mm_loadu_ps(dst));
+					sides = _mm_add_ps(sides, _mm_loadl_pi(_mm_setzero_ps(), reinterpret_cast<const __m64*>(dst + 4)));
 				}
+
+				_mm_storeu_ps(dst, front);
+				_mm_storel_pi(reinterpret_cast<__m64*>(dst + 4), sides);
 			}
 		}
-		else if (port.num_channels == 8)
+		else
 		{
-			if (first_mix)
+			static constexpr float minus_3db = 0.707f; // value taken from https://www.dolby.com/us/en/technologies/a-guide-to-dolby-metadata.pdf
+
+			const __m128 k = _mm_set1_ps(minus_3db);
+			const __m128 half = _mm_set1_ps(0.5f);
+
+			for (u32 i = 0; i < AUDIO_BUFFER_SAMPLES; i++)
 			{
-				for (u32 out = 0, in = 0; out < out_buffer_sz; out += channels, in += 8)
+				const __m128 front = _mm_load_ps(in + i * 8);
+				const __m128 back = _mm_mul_ps(_mm_load_ps(in + i * 8 + 4), half);
+
+				// Don't mix in the lfe as per dolby specification and based on documentation
+				const __m128 mid = _mm_mul_ps(_mm_shuffle_ps(front, front, _MM_SHUFFLE(2, 2, 2, 2)), half);
+
+				// Same summation order as the scalar version: front * -3dB + mid + side + rear
+				__m128 lr = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(front, k), mid), _mm_movehl_ps(back, back)), back);
+
+				if constexpr (!First)
 				{
-					step_volume(port);
-
-					const float left       = buf[in + 0] * m;
-					const float right      = buf[in + 1] * m;
-					const float center     = buf[in + 2] * m;
-					[[maybe_unused]]
-					const float low_freq   = buf[in + 3] * m;
-					const float rear_left  = buf[in + 4] * m;
-					const float rear_right = buf[in + 5] * m;
-					const float side_left  = buf[in + 6] * m;
-					const float side_right = buf[in + 7] * m;
-
-					if constexpr (downmix == audio_downmix::downmix_to_stereo)
-					{
-						// Don't mix in the lfe as per dolby specification and based on documentation
-						const float mid = center * 0.5f;
-						out_buffer[out + 0] = left * minus_3db + mid + side_left * 0.5f + rear_left * 0.5f;
-						out_buffer[out + 1] = right * minus_3db + mid + side_right * 0.5f + rear_right * 0.5f;
-					}
-					else if constexpr (downmix == audio_downmix::downmix_to_5_1)
-					{
-						out_buffer[out + 0] = left;
-						out_buffer[out + 1] = right;
-						out_buffer[out + 2] = center;
-						out_buffer[out + 3] = low_freq;
-						out_buffer[out + 4] = side_left + rear_left;
-						out_buffer[out + 5] = side_right + rear_right;
-					}
-					else
-					{
-						out_buffer[out + 0] = left;
-						out_buffer[out + 1] = right;
-						out_buffer[out + 2] = center;
-						out_buffer[out + 3] = low_freq;
-						out_buffer[out + 4] = rear_left;
-						out_buffer[out + 5] = rear_right;
-						out_buffer[out + 6] = side_left;
-						out_buffer[out + 7] = side_right;
-					}
+					lr = _mm_add_ps(lr, _mm_loadl_pi(_mm_setzero_ps(), reinterpret_cast<const __m64*>(out + i * 2)));
 				}
-				first_mix = false;
+
+				_mm_storel_pi(reinterpret_cast<__m64*>(out + i * 2), lr);
 			}
-			else
+		}
+	}
+}
+
+template <audio_downmix downmix>
+void cell_audio_thread::mix(float *out_buffer, s32 offset)
+{
+	AUDIT(out_buffer != nullptr);
+
+	perf_meter<"AUDIOMIX"_u64> perf0;
+
+	constexpr u32 channels = downmix == audio_downmix::no_downmix ? 8 : downmix == audio_downmix::downmix_to_5_1 ? 6 : 2;
+	constexpr u32 out_buffer_sz = channels * AUDIO_BUFFER_SAMPLES;
+
+	bool first_mix = true;
+
+	const float master_volume = g_cfg.audio.volume / 100.0f;
+
+	// Per-sample volume and decoded port samples
+	alignas(32) float volume[AUDIO_BUFFER_SAMPLES];
+	alignas(32) float samples[AUDIO_BUFFER_SAMPLES * 8];
+
+	// mixing
+	for (auto& port : ports)
+	{
+		if (port.state != audio_port_state::started) continue;
+
+		auto buf = port.get_vm_ptr(offset);
+
+		if (port.num_channels != 2 && port.num_channels != 8)
+		{
+			fmt::throw_exception("Unknown channel count (port=%u, channel=%d)", port.number, port.num_channels);
+		}
+
+		// part of cellAudioSetPortLevel functionality
+		// spread port volume changes over 13ms
+		if (port.level_set.load().inc == 0.0f)
+		{
+			std::fill_n(volume, AUDIO_BUFFER_SAMPLES, port.level * master_volume);
+		}
+		else
+		{
+			for (u32 i = 0; i < AUDIO_BUFFER_SAMPLES; i++)
 			{
-				for (u32 out = 0, in = 0; out < out_buffer_sz; out += channels, in += 8)
+				const auto param = port.level_set.load();
+
+				if (param.inc != 0.0f)
 				{
-					step_volume(port);
-
-					const float left       = buf[in + 0] * m;
-					const float right      = buf[in + 1] * m;
-					const float center     = buf[in + 2] * m;
-					const float low_freq   = buf[in + 3] * m;
-					const float rear_left  = buf[in + 4] * m;
-					const float rear_right = buf[in + 5] * m;
-					const float side_left  = buf[in + 6] * m;
-					const float side_right = buf[in + 7] * m;
-
-					if constexpr (downmix == audio_downmix::downmix_to_stereo)
-					{
-						// Don't mix in the lfe as per dolby specification and based on documentation
-						const float mid = center * 0.5f;
-						out_buffer[out + 0] += left * minus_3db + mid + side_left * 0.5f + rear_left * 0.5f;
-						out_buffer[out + 1] += right * minus_3db + mid + side_right * 0.5f + rear_right * 0.5f;
-					}
-					else if constexpr (downmix == audio_downmix::downmix_to_5_1)
-					{
-						out_buffer[out + 0] += left;
-						out_buffer[out + 1] += right;
-						out_buffer[out + 2] += center;
-						out_buffer[out + 3] += low_freq;
-						out_buffer[out + 4] += side_left + rear_left;
-						out_buffer[out + 5] += side_right + rear_right;
-					}
-					else
+					port.level += param.inc;
+					const bool dec = param.inc < 0.0f;
+
+					if ((!dec && param.value - port.level <= 0.0f) || (dec && param.value - port.level >= 0.0f))
 					{
-						out_buffer[out + 0] += left;
-						out_buffer[out + 1] += right;
-						out_buffer[out + 2] += center;
-						out_buffer[out + 3] += low_freq;
-						out_buffer[out + 4] += rear_left;
-						out_buffer[out + 5] += rear_right;
-						out_buffer[out + 6] += side_left;
-						out_buffer[out + 7] += side_right;
+						port.level = param.value;
+						port.level_set.compare_and_swap(param, { param.value, 0.0f });
 					}
 				}
+
+				volume[i] = port.level * master_volume;
+			}
+		}
+
+		if (port.num_channels == 2)
+		{
+			audio_decode_port<2>(samples, buf, volume);
+
+			if (first_mix)
+			{
+				audio_mix_stereo<channels, true>(out_buffer, samples);
+			}
+			else
+			{
+				audio_mix_stereo<channels, false>(out_buffer, samples);
 			}
 		}
 		else
 		{
-			fmt::throw_exception("Unknown channel count (port=%u, channel=%d)", port.number, port.num_channels);
+			audio_decode_port<8>(samples, buf, volume);
+
+			if (first_mix)
+			{
+				audio_mix_surround<channels, true>(out_buffer, samples);
+			}
+			else
+			{
+				audio_mix_surround<channels, false>(out_buffer, samples);
+			}
 		}
+
+		first_mix = false;
 	}
 
 	// Nothing was mixed, memset out_buffer to 0
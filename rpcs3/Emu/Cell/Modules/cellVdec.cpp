@@ -1,6 +1,7 @@
 #include "stdafx.h"
 #include "Emu/IdManager.h"
 #include "Emu/perf_meter.hpp"
+#include "Emu/system_config.h"
 #include "Emu/Cell/PPUModule.h"
 #include "Emu/Cell/lv2/sys_sync.h"
 #include "Emu/Cell/lv2/sys_ppu_thread.h"
@@ -184,6 +185,10 @@ struct vdec_context final
 			fmt::throw_exception("avcodec_alloc_context3() failed (type=0x%x)", type);
 		}
 
+		// Slice threading is always allowed, frame threading delays picture output
+		ctx->thread_count = g_cfg.video.vdec_threads;
+		ctx->thread_type = FF_THREAD_SLICE | (g_cfg.video.vdec_frame_threading ? FF_THREAD_FRAME : 0);
+
 		AVDictionary* opts{};
 		av_dict_set(&opts, "refcounted_frames", "1", 0);
 
@@ -195,6 +200,8 @@ struct vdec_context final
 			avcodec_free_context(&ctx);
 			fmt::throw_exception("avcodec_open2() failed (err=0x%x, opts=%d)", err, opts ? 1 : 0);
 		}
+
+		cellVdec.notice("Video decoder opened (type=0x%x, threads=%d, frame_threading=%d)", type, ctx->thread_count, !!(ctx->active_thread_type & FF_THREAD_FRAME));
 	}
 
 	~vdec_context()
@@ -290,10 +297,20 @@ struct vdec_context final
 				{
 					if (cmd->mode == -1)
 					{
-						break;
-					}
+						// Frame threading holds back pictures, drain them before the sequence ends
+						if (!(ctx->active_thread_type & FF_THREAD_FRAME))
+						{
+							break;
+						}
 
-					if (int ret = avcodec_send_packet(ctx, &packet); ret < 0)
+						if (int ret = avcodec_send_packet(ctx, nullptr); ret < 0)
+						{
+							char av_error[AV_ERROR_MAX_STRING_SIZE];
+							av_make_error_string(av_error, AV_ERROR_MAX_STRING_SIZE, ret);
+							fmt::throw_exception("AU draining error(0x%x): %s", ret, av_error);
+						}
+					}
+					else if (int ret = avcodec_send_packet(ctx, &packet); ret < 0)
 					{
 						char av_error[AV_ERROR_MAX_STRING_SIZE];
 						av_make_error_string(av_error, AV_ERROR_MAX_STRING_SIZE, ret);
@@ -317,6 +334,12 @@ struct vdec_context final
 							{
 								break;
 							}
+							else if (ret == AVERROR_EOF)
+							{
+								// Drained, make the decoder accept new packets
+								avcodec_flush_buffers(ctx);
+								break;
+							}
 							else
 							{
 								char av_error[AV_ERROR_MAX_STRING_SIZE];
@@ -423,10 +446,7 @@ struct vdec_context final
 						lv2_obj::sleep(ppu);
 					}
 
-					if (cmd->mode != -1)
-					{
-						break;
-					}
+					break;
 				}
 
 				if (out_max)
@@ -883,6 +903,19 @@ error_code cellVdecGetPicture(u32 handle, vm::cptr<CellVdecPicFormat> format, vm
 		}
 		}
 
+		if (in_f == AV_PIX_FMT_YUV420P && out_f == AV_PIX_FMT_YUV420P)
+		{
+			// Same layout, copy the planes into the guest buffer without scaling
+			u8* const out_y = outBuff.get_ptr();
+			u8* const out_u = out_y + w * h;
+			u8* const out_v = out_y + w * h * 5 / 4;
+
+			av_image_copy_plane(out_y, w, frame->data[0], frame->linesize[0], w, h);
+			av_image_copy_plane(out_u, w / 2, frame->data[1], frame->linesize[1], w / 2, h / 2);
+			av_image_copy_plane(out_v, w / 2, frame->data[2], frame->linesize[2], w / 2, h / 2);
+			return CELL_OK;
+		}
+
 		vdec->sws = sws_getCachedContext(vdec->sws, w, h, in_f, w, h, out_f, SWS_POINT, nullptr, nullptr, nullptr);
 
 		u8* in_data[4] = { frame->data[0], frame->data[1], frame->data[2], alpha_plane.get() };
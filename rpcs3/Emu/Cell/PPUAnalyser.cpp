@@ -4,10 +4,13 @@
 #include "PPUOpcodes.h"
 #include "PPUModule.h"
 #include "Emu/system_config.h"
+#include "Crypto/sha1.h"
+#include "Utilities/Thread.h"
 
 #include <unordered_set>
 #include "util/yaml.hpp"
 #include "util/asm.hpp"
+#include "util/sysinfo.hpp"
 
 LOG_CHANNEL(ppu_validator);
 
@@ -529,7 +532,243 @@ namespace ppu_patterns
 	};
 }
 
+namespace
+{
+	// Analysis results are stored as flat arrays, one per field, followed by the concatenated
+	// per-function blocks, calls, callers and names
+	struct ppu_analysis_header
+	{
+		u64 magic;
+		u32 version;
+		u32 func_count;
+		u32 block_count;
+		u32 call_count;
+		u32 caller_count;
+		u32 name_size;
+	};
+
+	constexpr u64 c_analysis_magic = "PPUANLYS"_u64;
+	constexpr u32 c_analysis_version = 1;
+
+	template <typename T>
+	void append_array(std::vector<u8>& out, const std::vector<T>& data)
+	{
+		const usz pos = out.size();
+		out.resize(pos + data.size() * sizeof(T));
+		std::memcpy(out.data() + pos, data.data(), data.size() * sizeof(T));
+	}
+
+	template <typename T>
+	bool read_array(const std::vector<u8>& in, usz& pos, std::vector<T>& data, usz count)
+	{
+		if ((in.size() - pos) / sizeof(T) < count)
+		{
+			return false;
+		}
+
+		data.resize(count);
+		std::memcpy(data.data(), in.data() + pos, count * sizeof(T));
+		pos += count * sizeof(T);
+		return true;
+	}
+
+	void save_analysis(const std::string& path, const std::vector<ppu_function>& funcs)
+	{
+		std::vector<u32> addr, toc, size, attr, stack_frame, trampoline, block_count, call_count, caller_count, name_size;
+		std::vector<u32> blocks, calls, callers;
+		std::string names;
+
+		for (const ppu_function& func : funcs)
+		{
+			addr.push_back(func.addr);
+			toc.push_back(func.toc);
+			size.push_back(func.size);
+			attr.push_back(static_cast<u32>(func.attr));
+			stack_frame.push_back(func.stack_frame);
+			trampoline.push_back(func.trampoline);
+			block_count.push_back(::size32(func.blocks));
+			call_count.push_back(::size32(func.calls));
+			caller_count.push_back(::size32(func.callers));
+			name_size.push_back(::size32(func.name));
+
+			for (auto [block_addr, block_size] : func.blocks)
+			{
+				blocks.push_back(block_addr);
+				blocks.push_back(block_size);
+			}
+
+			calls.insert(calls.end(), func.calls.begin(), func.calls.end());
+			callers.insert(callers.end(), func.callers.begin(), func.callers.end());
+			names += func.name;
+		}
+
+		const ppu_analysis_header header{c_analysis_magic, c_analysis_version, ::size32(funcs), ::size32(blocks) / 2, ::size32(calls), ::size32(callers), ::size32(names)};
+
+		std::vector<u8> out(sizeof(header));
+		std::memcpy(out.data(), &header, sizeof(header));
+
+		for (const auto* field : {&addr, &toc, &size, &attr, &stack_frame, &trampoline, &block_count, &call_count, &caller_count, &name_size, &blocks, &calls, &callers})
+		{
+			append_array(out, *field);
+		}
+
+		out.insert(out.end(), names.begin(), names.end());
+
+		// Write to a temporary file first so that a partially written cache is never loaded
+		if (!fs::write_file(path + ".tmp", fs::rewrite, out) || !fs::rename(path + ".tmp", path, true))
+		{
+			ppu_log.error("Failed to save PPU analysis cache %s (%s)", path, fs::g_tls_error);
+		}
+	}
+
+	bool load_analysis(const std::string& path, std::vector<ppu_function>& funcs)
+	{
+		fs::file file(path);
+
+		if (!file)
+		{
+			return false;
+		}
+
+		const std::vector<u8> in = file.to_vector<u8>();
+
+		ppu_analysis_header header{};
+
+		if (in.size() < sizeof(header) || (std::memcpy(&header, in.data(), sizeof(header)), header.magic != c_analysis_magic) || header.version != c_analysis_version)
+		{
+			return false;
+		}
+
+		std::vector<u32> addr, toc, size, attr, stack_frame, trampoline, block_count, call_count, caller_count, name_size;
+		std::vector<u32> blocks, calls, callers;
+		std::vector<char> names;
+
+		usz pos = sizeof(header);
+
+		for (auto* field : {&addr, &toc, &size, &attr, &stack_frame, &trampoline, &block_count, &call_count, &caller_count, &name_size})
+		{
+			if (!read_array(in, pos, *field, header.func_count))
+			{
+				return false;
+			}
+		}
+
+		if (!read_array(in, pos, blocks, header.block_count * u64{2}) ||
+			!read_array(in, pos, calls, header.call_count) ||
+			!read_array(in, pos, callers, header.caller_count) ||
+			!read_array(in, pos, names, header.name_size) ||
+			pos != in.size())
+		{
+			return false;
+		}
+
+		funcs.resize(header.func_count);
+
+		usz block_pos = 0, call_pos = 0, caller_pos = 0, name_pos = 0;
+
+		for (u32 i = 0; i < header.func_count; i++)
+		{
+			if (blocks.size() / 2 - block_pos < block_count[i] || calls.size() - call_pos < call_count[i] ||
+				callers.size() - caller_pos < caller_count[i] || names.size() - name_pos < name_size[i])
+			{
+				return false;
+			}
+
+			ppu_function& func = funcs[i];
+			func.addr = addr[i];
+			func.toc = toc[i];
+			func.size = size[i];
+
+			for (u32 bit = 0; bit < bs_t<ppu_attr>::bitsize; bit++)
+			{
+				if (attr[i] & (1u << bit))
+				{
+					func.attr += static_cast<ppu_attr>(bit);
+				}
+			}
+
+			func.stack_frame = stack_frame[i];
+			func.trampoline = trampoline[i];
+
+			// Sorted input, so every insertion is at the end
+			for (u32 j = 0; j < block_count[i]; j++, block_pos++)
+			{
+				func.blocks.emplace_hint(func.blocks.end(), blocks[block_pos * 2], blocks[block_pos * 2 + 1]);
+			}
+
+			func.calls.insert(calls.begin() + call_pos, calls.begin() + call_pos + call_count[i]);
+			func.callers.insert(callers.begin() + caller_pos, callers.begin() + caller_pos + caller_count[i]);
+			func.name.assign(names.data() + name_pos, name_size[i]);
+
+			call_pos += call_count[i];
+			caller_pos += caller_count[i];
+			name_pos += name_size[i];
+		}
+
+		return true;
+	}
+}
+
 void ppu_module::analyse(u32 lib_toc, u32 entry, const u32 sec_end, const std::basic_string<u32>& applied)
+{
+	std::string cache_path;
+
+	if (g_cfg.core.ppu_analysis_cache && funcs.empty() && !segs.empty() && std::any_of(std::begin(sha1), std::end(sha1), [](uchar c) { return c != 0; }))
+	{
+		// The result depends on the module contents, its load addresses, the analysis arguments and applied patches
+		sha1_context ctx;
+		u8 key[20];
+
+		sha1_starts(&ctx);
+		sha1_update(&ctx, sha1, sizeof(sha1));
+
+		for (u32 arg : {lib_toc, entry, sec_end})
+		{
+			sha1_update(&ctx, reinterpret_cast<const u8*>(&arg), sizeof(arg));
+		}
+
+		for (const auto* list : {&segs, &secs})
+		{
+			for (const ppu_segment& seg : *list)
+			{
+				const u32 data[]{seg.addr, seg.size, seg.type, seg.flags, seg.filesz};
+				sha1_update(&ctx, reinterpret_cast<const u8*>(data), sizeof(data));
+			}
+		}
+
+		for (u32 addr : applied)
+		{
+			const u32 data[]{addr, vm::check_addr(addr) ? vm::read32(addr).value() : 0};
+			sha1_update(&ctx, reinterpret_cast<const u8*>(data), sizeof(data));
+		}
+
+		sha1_finish(&ctx, key);
+
+		const std::string cache_dir = fs::get_cache_dir() + "cache/ppu_analysis/";
+
+		if (fs::create_path(cache_dir))
+		{
+			cache_path = cache_dir + fmt::format("%s.bin", fmt::base57(key, 16));
+		}
+
+		if (!cache_path.empty() && load_analysis(cache_path, funcs))
+		{
+			ppu_log.notice("Loaded PPU analysis of %s from cache (%u functions)", name, funcs.size());
+			return;
+		}
+
+		funcs.clear();
+	}
+
+	analyse_uncached(lib_toc, entry, sec_end, applied);
+
+	if (!cache_path.empty())
+	{
+		save_analysis(cache_path, funcs);
+	}
+}
+
+void ppu_module::analyse_uncached(u32 lib_toc, u32 entry, const u32 sec_end, const std::basic_string<u32>& applied)
 {
 	// Assume first segment is executable
 	const u32 start = segs[0].addr;
@@ -617,30 +856,73 @@ void ppu_module::analyse(u32 lib_toc, u32 entry, const u32 sec_end, const std::b
 		return it == known_functions.end() ? end : *it;
 	};
 
-	// Find references indiscriminately
-	for (const auto& seg : segs)
+	// Find references indiscriminately (segments are scanned in chunks, the merged set doesn't depend on their order)
 	{
-		if (!seg.addr) continue;
+		struct scan_range
+		{
+			u32 addr;
+			u32 end;
+			std::vector<u32> refs;
+		};
 
-		for (vm::cptr<u32> ptr = vm::cast(seg.addr); ptr.addr() < seg.addr + seg.size; ptr++)
+		std::vector<scan_range> ranges;
+		u64 total_size = 0;
+
+		for (const auto& seg : segs)
 		{
-			const u32 value = *ptr;
+			if (!seg.addr) continue;
+
+			const u64 seg_end = u64{seg.addr} + seg.size;
 
-			if (value % 4)
+			for (u64 addr = seg.addr; addr < seg_end; addr += 0x40000)
 			{
-				continue;
+				ranges.push_back({static_cast<u32>(addr), static_cast<u32>(std::min<u64>(addr + 0x40000, seg_end)), {}});
 			}
 
-			for (const auto& _seg : segs)
+			total_size += seg.size;
+		}
+
+		auto scan = [&](scan_range& range)
+		{
+			for (vm::cptr<u32> ptr = vm::cast(range.addr); ptr.addr() < range.end; ptr++)
 			{
-				if (!_seg.addr) continue;
+				const u32 value = *ptr;
 
-				if (value >= start && value < end)
+				if (value % 4 == 0 && value >= start && value < end)
 				{
-					addr_heap.emplace(value);
-					break;
+					range.refs.push_back(value);
 				}
 			}
+		};
+
+		// Not worth spawning threads for small modules
+		const u32 thread_count = total_size >= 0x100000 ? std::min<u32>(utils::get_thread_count(), ::size32(ranges)) : 1;
+
+		if (thread_count > 1)
+		{
+			atomic_t<usz> next = 0;
+
+			named_thread_group workers("PPU Analyser ", thread_count, [&]()
+			{
+				for (usz i; (i = next++) < ranges.size();)
+				{
+					scan(ranges[i]);
+				}
+			});
+
+			workers.join();
+		}
+		else
+		{
+			for (auto& range : ranges)
+			{
+				scan(range);
+			}
+		}
+
+		for (const auto& range : ranges)
+		{
+			addr_heap.insert(range.refs.begin(), range.refs.end());
 		}
 	}
 
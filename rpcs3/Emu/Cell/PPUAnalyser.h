@@ -100,6 +100,7 @@ struct ppu_module
 	}
 
 	void analyse(u32 lib_toc, u32 entry, u32 end, const std::basic_string<u32>& applied);
+	void analyse_uncached(u32 lib_toc, u32 entry, u32 end, const std::basic_string<u32>& applied);
 	void validate(u32 reloc);
 };
 
@@ -269,6 +269,94 @@ static bool ppu_fallback(ppu_thread& ppu, ppu_opcode_t op)
 	return false;
 }
 
+// Incremented whenever interpreter cache entries are replaced, invalidates all decoded traces
+static atomic_t<u64> g_ppu_trace_epoch{0};
+
+static void ppu_invalidate_traces()
+{
+	g_ppu_trace_epoch++;
+}
+
+// Straight-line run of instruction handlers ending at a branch or at the size limit
+// Opcodes are still read from guest memory on execution, so code modifications are seen as without traces
+struct ppu_trace
+{
+	static constexpr u32 max_size = 32;
+
+	u32 addr = 1; // Invalid tag (unaligned)
+	u32 size = 0;
+	decltype(&ppu_interpreter::UNK) ops[max_size];
+};
+
+// Per-thread direct-mapped trace cache, slots are allocated on first use
+struct ppu_trace_cache
+{
+	u64 epoch = 0; // All tags are initially invalid
+	std::array<std::unique_ptr<ppu_trace>, 512> traces;
+
+	const ppu_trace& get(u32 addr)
+	{
+		if (const u64 epoch = g_ppu_trace_epoch; epoch != this->epoch) [[unlikely]]
+		{
+			for (auto& trace : traces)
+			{
+				if (trace)
+				{
+					trace->addr = 1;
+				}
+			}
+
+			this->epoch = epoch;
+		}
+
+		auto& slot = traces[(addr / 4) % traces.size()];
+
+		if (!slot)
+		{
+			slot = std::make_unique<ppu_trace>();
+		}
+
+		ppu_trace& trace = *slot;
+
+		if (trace.addr != addr)
+		{
+			trace.addr = addr;
+			trace.size = 0;
+
+			const u64 fallback = reinterpret_cast<uptr>(ppu_fallback);
+
+			// Stay within the 64K block (executable ranges are registered at this granularity)
+			for (u32 pos = addr; trace.size < ppu_trace::max_size && (pos == addr || pos % 0x10000); pos += 4)
+			{
+				const u64 func = ppu_ref(pos);
+
+				if (func == fallback)
+				{
+					// Unregistered instruction, must go through ppu_fallback
+					// Don't keep the tag: the run is extended once ppu_fallback registers it
+					trace.addr = 1;
+					break;
+				}
+
+				trace.ops[trace.size++] = reinterpret_cast<decltype(&ppu_interpreter::UNK)>(func);
+
+				switch (g_ppu_itype.decode(vm::read32(pos)))
+				{
+				case ppu_itype::B:
+				case ppu_itype::BC:
+				case ppu_itype::BCLR:
+				case ppu_itype::BCCTR:
+				case ppu_itype::SC:
+					return trace;
+				default: break;
+				}
+			}
+		}
+
+		return trace;
+	}
+};
+
 // TODO: Make this a dispatch call
 void ppu_recompiler_fallback(ppu_thread& ppu)
 {
@@ -400,6 +488,8 @@ extern void ppu_register_range(u32 addr, u32 size)
 		addr += 4;
 		size -= 4;
 	}
+
+	ppu_invalidate_traces();
 }
 
 extern void ppu_register_function_at(u32 addr, u32 size, ppu_function_t ptr)
@@ -408,6 +498,7 @@ extern void ppu_register_function_at(u32 addr, u32 size, ppu_function_t ptr)
 	if (ptr)
 	{
 		ppu_ref(addr) = (reinterpret_cast<uptr>(ptr) & 0x7fff'ffff'ffffu) | (ppu_ref(addr) & ~0x7fff'ffff'ffffu);
+		ppu_invalidate_traces();
 		return;
 	}
 
@@ -439,6 +530,8 @@ extern void ppu_register_function_at(u32 addr, u32 size, ppu_function_t ptr)
 		addr += 4;
 		size -= 4;
 	}
+
+	ppu_invalidate_traces();
 }
 
 atomic_t<bool> g_debugger_pause_all_threads_on_bp = true;
@@ -496,6 +589,8 @@ extern void ppu_breakpoint(u32 addr, bool is_adding)
 		// Remove breakpoint
 		ppu_ref(addr) = ppu_cache(addr);
 	}
+
+	ppu_invalidate_traces();
 }
 
 //sets breakpoint, does nothing if there is a breakpoint there already
@@ -511,6 +606,7 @@ extern void ppu_set_breakpoint(u32 addr)
 	if (ppu_ref(addr) != _break)
 	{
 		ppu_ref(addr) = _break;
+		ppu_invalidate_traces();
 	}
 }
 
@@ -527,6 +623,7 @@ extern void ppu_remove_breakpoint(u32 addr)
 	if (ppu_ref(addr) == _break)
 	{
 		ppu_ref(addr) = ppu_cache(addr);
+		ppu_invalidate_traces();
 	}
 }
 
@@ -566,6 +663,9 @@ extern bool ppu_patch(u32 addr, u32 value)
 		{
 			ppu_ref(addr) = ppu_cache(addr);
 		}
+
+		// Traces also hold the opcode
+		ppu_invalidate_traces();
 	}
 
 	return true;
@@ -1030,6 +1130,43 @@ void ppu_thread::exec_task()
 	const auto cache = vm::g_exec_addr;
 	using func_t = decltype(&ppu_interpreter::UNK);
 
+	if (g_cfg.core.ppu_trace_interpreter)
+	{
+		std::unique_ptr<ppu_trace_cache> traces;
+
+		while (true)
+		{
+			if (state) [[unlikely]]
+			{
+				if (test_stopped()) return;
+
+				// Decode single instruction (may be step)
+				if (reinterpret_cast<func_t>(ppu_ref(cia))(*this, {vm::read32(cia).get()})) { cia += 4; }
+				continue;
+			}
+
+			if (!traces) [[unlikely]]
+			{
+				traces = std::make_unique<ppu_trace_cache>();
+			}
+
+			const ppu_trace& trace = traces->get(cia);
+
+			if (!trace.size) [[unlikely]]
+			{
+				// Let ppu_fallback register the instruction
+				if (reinterpret_cast<func_t>(ppu_ref(cia))(*this, {vm::read32(cia).get()})) { cia += 4; }
+				continue;
+			}
+
+			// Threaded dispatch over the run, leave it as soon as a handler doesn't fall through or the state changes
+			for (auto op = trace.ops, end = trace.ops + trace.size; op != end && !state && (*op)(*this, {vm::read32(cia).get()}); op++)
+			{
+				cia += 4;
+			}
+		}
+	}
+
 	while (true)
 	{
 		const auto exec_op = [this](u64 op)
@@ -2130,6 +2267,89 @@ namespace
 			map.erase(found);
 		}
 	};
+
+	// Compilation jobs of all modules being initialized concurrently (largest first)
+	struct jit_job_queue
+	{
+		struct job
+		{
+			// Code size in bytes (priority and memory estimate)
+			usz size;
+
+			const std::string* cache_path;
+			const std::string* obj_name;
+			const ppu_module* part;
+
+			// Number of unfinished jobs of the owner
+			atomic_t<u32>* remaining;
+
+			bool operator<(const job& rhs) const
+			{
+				return size < rhs.size;
+			}
+		};
+
+		shared_mutex mutex;
+
+		// Max-heap
+		std::vector<job> jobs;
+
+		// Estimated memory usage of running compilers
+		atomic_t<u64> mem_in_use = 0;
+
+		// Rough estimate of LLVM memory usage per byte of PPU code
+		static constexpr u64 mem_per_byte = 256;
+
+		void push(const job& _job)
+		{
+			std::lock_guard lock(mutex);
+			jobs.emplace_back(_job);
+			std::push_heap(jobs.begin(), jobs.end());
+		}
+
+		bool pop(job& out)
+		{
+			std::lock_guard lock(mutex);
+
+			if (jobs.empty())
+			{
+				return false;
+			}
+
+			std::pop_heap(jobs.begin(), jobs.end());
+			out = jobs.back();
+			jobs.pop_back();
+			return true;
+		}
+
+		// Wait until memory for the job is available (one job can always run)
+		void acquire_memory(u64 size)
+		{
+			const u64 limit = g_cfg.core.llvm_memory_limit * 0x100000ull;
+
+			while (true)
+			{
+				const u64 cur = mem_in_use;
+
+				if (limit && cur && cur + size > limit)
+				{
+					mem_in_use.wait(cur);
+					continue;
+				}
+
+				if (mem_in_use.compare_and_swap_test(cur, cur + size))
+				{
+					return;
+				}
+			}
+		}
+
+		void release_memory(u64 size)
+		{
+			mem_in_use -= size;
+			mem_in_use.notify_all();
+		}
+	};
 }
 #endif
 
@@ -2588,8 +2808,16 @@ extern void ppu_initialize()
 		dir_queue.insert(std::end(dir_queue), std::begin(dirs), std::end(dirs));
 	}
 
+	// Compile main module concurrently with other modules, so their jobs are scheduled together (linked below)
+	named_thread_group main_worker("PPU Main Worker ", compile_main ? 1 : 0, [&]()
+	{
+		ppu_initialize(_main);
+	});
+
 	ppu_precompile(dir_queue, &prx_list);
 
+	main_worker.join();
+
 	if (Emu.IsStopped())
 	{
 		return;
@@ -2646,9 +2874,13 @@ bool ppu_initialize(const ppu_module& info, bool check_only)
 			}
 		}
 
+		ppu_invalidate_traces();
+
 		return false;
 	}
 
+	perf_meter<"PPU_INIT"_u64> perf0;
+
 	// Link table
 	static const std::unordered_map<std::string, u64> s_link_table = []()
 	{
@@ -2753,15 +2985,12 @@ bool ppu_initialize(const ppu_module& info, bool check_only)
 	// Difference between function name and current location
 	const u32 reloc = info.relocs.empty() ? 0 : info.segs.at(0).addr;
 
-	// Info sent to threads
-	std::vector<std::pair<std::string, ppu_module>> workload;
+	// Info sent to threads (name, part, code size)
+	std::vector<std::tuple<std::string, ppu_module, usz>> workload;
 
 	// Info to load to main JIT instance (true - compiled)
 	std::vector<std::pair<std::string, bool>> link_workload;
 
-	// Sync variable to acquire workloads
-	atomic_t<u32> work_cv = 0;
-
 	bool compiled_new = false;
 
 	while (!jit_mod.init && fpos < info.funcs.size())
@@ -2984,7 +3213,7 @@ bool ppu_initialize(const ppu_module& info, bool check_only)
 		link_workload.back().second = true;
 
 		// Fill workload list for compilation
-		workload.emplace_back(std::move(obj_name), std::move(part));
+		workload.emplace_back(std::move(obj_name), std::move(part), bsize);
 	}
 
 	if (check_only)
@@ -3011,6 +3240,16 @@ bool ppu_initialize(const ppu_module& info, bool check_only)
 			atomic_t<u64> index = 0;
 		};
 
+		auto& queue = g_fxo->get<jit_job_queue>();
+
+		// Number of own jobs not finished yet (may be taken by workers of other modules)
+		atomic_t<u32> remaining = ::size32(workload);
+
+		for (const auto& [obj_name, part, size] : workload)
+		{
+			queue.push({size, &cache_path, &obj_name, &part, &remaining});
+		}
+
 		// Prevent watchdog thread from terminating
 		g_watchdog_hold_ctr++;
 
@@ -3019,31 +3258,47 @@ bool ppu_initialize(const ppu_module& info, bool check_only)
 			// Set low priority
 			thread_ctrl::scoped_priority low_prio(-1);
 
-			for (u32 i = work_cv++; i < workload.size(); i = work_cv++, g_progr_pdone++)
+			// Take the largest job of any module
+			for (jit_job_queue::job job; queue.pop(job); g_progr_pdone++)
 			{
-				if (Emu.IsStopped())
+				if (!Emu.IsStopped())
 				{
-					continue;
-				}
+					// Allocate "core"
+					std::lock_guard jlock(g_fxo->get<jit_core_allocator>().sem);
+
+					const u64 mem_size = job.size * jit_job_queue::mem_per_byte;
+					queue.acquire_memory(mem_size);
 
-				// Keep allocating workload
-				const auto& [obj_name, part] = std::as_const(workload)[i];
+					ppu_log.warning("LLVM: Compiling module %s%s", *job.cache_path, *job.obj_name);
 
-				// Allocate "core"
-				std::lock_guard jlock(g_fxo->get<jit_core_allocator>().sem);
+					{
+						perf_meter<"PPU_COMP"_u64> perf1;
 
-				ppu_log.warning("LLVM: Compiling module %s%s", cache_path, obj_name);
+						// Use another JIT instance
+						jit_compiler jit2({}, g_cfg.core.llvm_cpu, 0x1);
+						ppu_initialize2(jit2, *job.part, *job.cache_path, *job.obj_name);
+					}
 
-				// Use another JIT instance
-				jit_compiler jit2({}, g_cfg.core.llvm_cpu, 0x1);
-				ppu_initialize2(jit2, part, cache_path, obj_name);
+					queue.release_memory(mem_size);
 
-				ppu_log.success("LLVM: Compiled module %s", obj_name);
+					ppu_log.success("LLVM: Compiled module %s", *job.obj_name);
+				}
+
+				if (job.remaining->sub_fetch(1) == 0)
+				{
+					job.remaining->notify_all();
+				}
 			}
 		});
 
 		threads.join();
 
+		// Wait for own jobs taken by workers of other modules
+		while (const u32 left = remaining)
+		{
+			remaining.wait(left);
+		}
+
 		g_watchdog_hold_ctr--;
 
 		if (Emu.IsStopped() || !get_current_cpu_thread())
@@ -3057,6 +3312,8 @@ bool ppu_initialize(const ppu_module& info, bool check_only)
 			g_progr = "Linking PPU modules...";
 		}
 
+		perf_meter<"PPU_LINK"_u64> perf1;
+
 		for (auto [obj_name, is_compiled] : link_workload)
 		{
 			if (Emu.IsStopped())
@@ -413,6 +413,26 @@ void spu_cache::initialize()
 		}
 	}
 
+	if (g_cfg.core.spu_decoder == spu_decoder_type::llvm)
+	{
+		// Defer programs which have a persistent compiled object, they are loaded on first dispatch
+		if (const auto& obj_path = g_fxo->get<spu_runtime>().get_obj_path(); !obj_path.empty())
+		{
+			const usz total = func_list.size();
+
+			std::erase_if(func_list, [&](const spu_program& func)
+			{
+				const std::string name = obj_path + spu_runtime::get_obj_name(func);
+				return fs::is_file(name + ".link") && fs::is_file(name + ".obj.gz");
+			});
+
+			if (const usz deferred = total - func_list.size())
+			{
+				spu_log.success("SPU Runtime: Found %u compiled programs, deferred to first dispatch.", deferred);
+			}
+		}
+	}
+
 	u32 worker_count = 0;
 
 	std::optional<scoped_progress_dialog> progr;
@@ -600,6 +620,112 @@ spu_runtime::spu_runtime()
 		fs::file(m_cache_path + "spu.log", fs::rewrite);
 		fs::file(m_cache_path + "spu-ir.log", fs::rewrite);
 	}
+
+#ifdef LLVM_AVAILABLE
+	if (g_cfg.core.spu_cache && !g_cfg.core.spu_debug && (g_cfg.core.spu_decoder == spu_decoder_type::llvm || g_cfg.core.spu_decoder == spu_decoder_type::fast))
+	{
+		// Settings which affect codegen
+		enum class spu_settings : u32
+		{
+			non_win32,
+			accurate_xfloat,
+			approx_xfloat,
+			accurate_dfma,
+			accurate_dma,
+			loop_detection,
+			verification,
+			profiling,
+			mfc_debug,
+
+			__bitset_enum_max
+		};
+
+		be_t<bs_t<spu_settings>> settings{};
+
+#ifndef _WIN32
+		settings += spu_settings::non_win32;
+#endif
+		if (g_cfg.core.spu_accurate_xfloat)
+			settings += spu_settings::accurate_xfloat;
+		if (g_cfg.core.spu_approx_xfloat)
+			settings += spu_settings::approx_xfloat;
+		if (g_cfg.core.llvm_accurate_dfma)
+			settings += spu_settings::accurate_dfma;
+		if (g_cfg.core.spu_accurate_dma)
+			settings += spu_settings::accurate_dma;
+		if (g_cfg.core.spu_loop_detection)
+			settings += spu_settings::loop_detection;
+		if (g_cfg.core.spu_verification)
+			settings += spu_settings::verification;
+		if (g_cfg.core.spu_prof)
+			settings += spu_settings::profiling;
+		if (g_cfg.core.mfc_debug)
+			settings += spu_settings::mfc_debug;
+
+		// Located next to the SPU cache file (version + block size type + settings + CPU)
+		m_obj_path = fmt::format("%sspu-%s-v1-tane-obj-%s-%s/", m_cache_path, fmt::to_lower(g_cfg.core.spu_block_size.to_string()), fmt::base57(settings), jit_compiler::cpu(g_cfg.core.llvm_cpu));
+
+		if (!fs::create_dir(m_obj_path) && fs::g_tls_error != fs::error::exist)
+		{
+			spu_log.error("Failed to create SPU object cache directory: %s (%s)", m_obj_path, fs::g_tls_error);
+			m_obj_path.clear();
+		}
+	}
+#endif
+}
+
+spu_runtime::~spu_runtime()
+{
+	const auto [dispatch_misses, branch_misses, rebuilds, hits] = get_stats();
+
+	if (!rebuilds)
+	{
+		return;
+	}
+
+	spu_log.notice("SPU Runtime: %u trampoline rebuilds, %u dispatch misses, %u branch misses.", rebuilds, dispatch_misses, branch_misses);
+
+	if (g_cfg.core.spu_prof && hits)
+	{
+		spu_log.notice("SPU Runtime: %u trampoline hits (dispatch miss rate: %.4f%%).", hits, 100. * dispatch_misses / (hits + dispatch_misses));
+	}
+}
+
+std::array<u64, 4> spu_runtime::get_stats() const
+{
+	u64 hits = 0;
+
+	if (g_cfg.core.spu_prof)
+	{
+		for (auto& bunch : m_stuff)
+		{
+			for (auto& item : bunch)
+			{
+				hits += item.hits;
+			}
+		}
+	}
+
+	return {m_dispatch_misses.load(), m_branch_misses.load(), m_rebuilds.load(), hits};
+}
+
+std::string spu_runtime::get_obj_name(const spu_program& func, u64* hash_start)
+{
+	sha1_context ctx;
+	u8 output[20];
+
+	sha1_starts(&ctx);
+	sha1_update(&ctx, reinterpret_cast<const u8*>(func.data.data()), func.data.size() * 4);
+	sha1_finish(&ctx, output);
+
+	if (hash_start)
+	{
+		be_t<u64> start;
+		std::memcpy(&start, output, sizeof(start));
+		*hash_start = start;
+	}
+
+	return fmt::format("spu-0x%05x-%s", func.entry_point, fmt::base57(output));
 }
 
 spu_item* spu_runtime::add_empty(spu_program&& data)
@@ -637,6 +763,20 @@ spu_function_t spu_runtime::rebuild_ubertrampoline(u32 id_inst)
 	// Prepare sorted list
 	static thread_local std::vector<std::pair<std::basic_string_view<u32>, spu_function_t>> m_flat_list;
 
+	// Functions tested before the binary search (only with SPU profiler)
+	struct hot_entry
+	{
+		u64 hits;
+		std::basic_string_view<u32> range;
+		spu_function_t func;
+
+		// Positions sufficient to distinguish the function from all others
+		std::array<u32, 8> pos;
+		u32 count;
+	};
+
+	static thread_local std::vector<hot_entry> m_hot_list;
+
 	// Remember top position
 	auto stuff_it = m_stuff.at(id_inst >> 12).begin();
 	auto stuff_end = m_stuff.at(id_inst >> 12).end();
@@ -646,14 +786,30 @@ spu_function_t spu_runtime::rebuild_ubertrampoline(u32 id_inst)
 			return stuff_it->trampoline;
 		}
 
+		m_rebuilds++;
 		m_flat_list.clear();
+		m_hot_list.clear();
 
 		for (auto it = stuff_it; it != stuff_end; ++it)
 		{
-			if (const auto ptr = it->compiled.load())
+			if (auto ptr = it->compiled.load())
 			{
 				std::basic_string_view<u32> range{it->data.data.data(), it->data.data.size()};
 				range.remove_prefix((it->data.entry_point - it->data.lower_bound) / 4);
+
+				if (g_cfg.core.spu_prof)
+				{
+					if (const auto stub = make_counting_stub(*it, ptr))
+					{
+						ptr = stub;
+					}
+
+					if (const u64 hits = it->hits)
+					{
+						m_hot_list.emplace_back(hot_entry{hits, range, ptr, {}, 0});
+					}
+				}
+
 				m_flat_list.emplace_back(range, ptr);
 			}
 			else
@@ -691,10 +847,71 @@ spu_function_t spu_runtime::rebuild_ubertrampoline(u32 id_inst)
 
 	auto result = beg->second;
 
+	// Size of the hottest function checks
+	u32 hot_size = 0;
+
+	if (size0 != 1 && !m_hot_list.empty())
+	{
+		// Most called functions are tested first
+		std::sort(m_hot_list.begin(), m_hot_list.end(), [](const hot_entry& a, const hot_entry& b)
+		{
+			return a.hits > b.hits;
+		});
+
+		if (m_hot_list.size() > 3)
+		{
+			m_hot_list.resize(3);
+		}
+
+		std::erase_if(m_hot_list, [&](hot_entry& h)
+		{
+			for (const auto& [range, func] : m_flat_list)
+			{
+				if (range.data() == h.range.data())
+				{
+					continue;
+				}
+
+				// Only compare defined words (zero words are holes)
+				auto differs = [&](u32 p)
+				{
+					return p < range.size() && p < h.range.size() && range[p] && h.range[p] && range[p] != h.range[p];
+				};
+
+				if (std::any_of(h.pos.begin(), h.pos.begin() + h.count, differs))
+				{
+					continue;
+				}
+
+				u32 p = 0;
+
+				while (p < range.size() && p < h.range.size() && !differs(p))
+				{
+					p++;
+				}
+
+				if (!differs(p) || h.count == h.pos.size())
+				{
+					// Cannot distinguish cheaply
+					return true;
+				}
+
+				h.pos[h.count++] = p;
+			}
+
+			// Load, compare and jne per position, final jmp
+			hot_size += h.count * 17 + 5;
+			return false;
+		});
+	}
+
 	if (size0 != 1)
 	{
+		// Total size of the trampoline
+		const u32 tr_size = size0 * 22 + 14 + hot_size;
+
 		// Allocate some writable executable memory
-		u8* const wxptr = jit_runtime::alloc(size0 * 22 + 14, 16);
+		u8* const wxptr = jit_runtime::alloc(tr_size, 16);
 
 		if (!wxptr)
 		{
@@ -707,7 +924,7 @@ spu_function_t spu_runtime::rebuild_ubertrampoline(u32 id_inst)
 		// Write jump instruction with rel32 immediate
 		auto make_jump = [&](u8 op, auto target)
 		{
-			ensure(raw + 8 <= wxptr + size0 * 22 + 16);
+			ensure(raw + 8 <= wxptr + tr_size + 2);
 
 			// Fallback to dispatch if no target
 			const u64 taddr = target ? reinterpret_cast<u64>(target) : reinterpret_cast<u64>(tr_dispatch);
@@ -732,6 +949,55 @@ spu_function_t spu_runtime::rebuild_ubertrampoline(u32 id_inst)
 			raw += 4;
 		};
 
+		// Emit load: mov eax, [rcx + addr]
+		auto make_load = [&](u32 level)
+		{
+			const u32 cmp_lsa = level * 4u;
+
+			if (cmp_lsa < 0x80)
+			{
+				*raw++ = 0x8b;
+				*raw++ = 0x41;
+				*raw++ = ::narrow<s8>(cmp_lsa);
+			}
+			else
+			{
+				*raw++ = 0x8b;
+				*raw++ = 0x81;
+				std::memcpy(raw, &cmp_lsa, 4);
+				raw += 4;
+			}
+		};
+
+		// LS address starting from PC is already loaded into rcx (see spu_runtime::tr_all)
+
+		for (const hot_entry& h : m_hot_list)
+		{
+			std::array<u8*, 8> rel32{};
+
+			for (u32 i = 0; i < h.count; i++)
+			{
+				make_load(h.pos[i]);
+
+				// Emit comparison: cmp eax, imm32
+				*raw++ = 0x3d;
+				std::memcpy(raw, &h.range[h.pos[i]], 4);
+				raw += 4;
+
+				make_jump(0x85, raw); // jne rel32 (stub)
+				rel32[i] = raw;
+			}
+
+			make_jump(0xe9, h.func); // jmp rel32
+
+			for (u32 i = 0; i < h.count; i++)
+			{
+				// Link mismatches to the next check
+				const s32 r32 = ::narrow<s32>(raw - rel32[i]);
+				std::memcpy(rel32[i] - 4, &r32, 4);
+			}
+		}
+
 		workload.clear();
 		workload.reserve(size0);
 		workload.emplace_back();
@@ -742,8 +1008,6 @@ spu_function_t spu_runtime::rebuild_ubertrampoline(u32 id_inst)
 		workload.back().beg   = beg;
 		workload.back().end   = _end;
 
-		// LS address starting from PC is already loaded into rcx (see spu_runtime::tr_all)
-
 		for (usz i = 0; i < workload.size(); i++)
 		{
 			// Get copy of the workload info
@@ -856,26 +1120,12 @@ spu_function_t spu_runtime::rebuild_ubertrampoline(u32 id_inst)
 			}
 
 			// Emit 32-bit comparison
-			ensure(raw + 12 <= wxptr + size0 * 22 + 16); // "Asm overflow"
+			ensure(raw + 12 <= wxptr + tr_size + 2); // "Asm overflow"
 
 			if (w.from != w.level)
 			{
-				// If necessary (level has advanced), emit load: mov eax, [rcx + addr]
-				const u32 cmp_lsa = w.level * 4u;
-
-				if (cmp_lsa < 0x80)
-				{
-					*raw++ = 0x8b;
-					*raw++ = 0x41;
-					*raw++ = ::narrow<s8>(cmp_lsa);
-				}
-				else
-				{
-					*raw++ = 0x8b;
-					*raw++ = 0x81;
-					std::memcpy(raw, &cmp_lsa, 4);
-					raw += 4;
-				}
+				// If necessary (level has advanced), emit load
+				make_load(w.level);
 			}
 
 			// Emit comparison: cmp eax, imm32
@@ -1025,6 +1275,47 @@ spu_function_t spu_runtime::find(const u32* ls, u32 addr) const
 	return nullptr;
 }
 
+spu_function_t spu_runtime::make_counting_stub(spu_item& item, spu_function_t target)
+{
+	if (item.counted_target == target)
+	{
+		return item.counted;
+	}
+
+	u8* const raw = jit_runtime::alloc(32, 16);
+
+	if (!raw)
+	{
+		return nullptr;
+	}
+
+	// Load counter address: mov rax, imm64
+	raw[0] = 0x48;
+	raw[1] = 0xb8;
+	const u64 counter = reinterpret_cast<u64>(&item.hits.raw());
+	std::memcpy(raw + 2, &counter, 8);
+
+	// lock inc qword ptr [rax]
+	raw[10] = 0xf0;
+	raw[11] = 0x48;
+	raw[12] = 0xff;
+	raw[13] = 0x00;
+
+	// Jump to the function
+	raw[14] = 0xe9;
+	// Compute the distance
+	const s64 rel = reinterpret_cast<u64>(target) - reinterpret_cast<u64>(raw + 14) - 5;
+	ensure(rel >= INT32_MIN && rel <= INT32_MAX);
+	const s32 r32 = static_cast<s32>(rel);
+	std::memcpy(raw + 15, &r32, 4);
+	raw[19] = 0xcc;
+
+	const auto result = reinterpret_cast<spu_function_t>(raw);
+	item.counted = result;
+	item.counted_target = target;
+	return result;
+}
+
 spu_function_t spu_runtime::make_branch_patchpoint(u16 data) const
 {
 	u8* const raw = jit_runtime::alloc(16, 16);
@@ -1094,7 +1385,7 @@ void spu_recompiler_base::dispatch(spu_thread& spu, void*, u8* rip)
 		return;
 	}
 
-	spu.jit->init();
+	spu.jit->get_runtime().count_dispatch_miss();
 
 	// Compile
 	if (spu._ref<u32>(spu.pc) == 0u)
@@ -1132,6 +1423,8 @@ void spu_recompiler_base::branch(spu_thread& spu, void*, u8* rip)
 		spu_log.todo("Special branch patchpoint hit.\nPlease report to the developer (0x%05x).", ls_off);
 	}
 
+	spu.jit->get_runtime().count_branch_miss();
+
 	// Find function
 	const auto func = spu.jit->get_runtime().find(static_cast<u32*>(spu._ptr<void>(0)), spu.pc);
 
@@ -4194,6 +4487,115 @@ class spu_llvm_recompiler : public spu_recompiler_base, public cpu_translator
 		m_ir->SetInsertPoint(_body);
 	}
 
+	// Get address of the external symbol which compiled modules may reference (0 if unknown)
+	static u64 get_link_address(std::string_view name)
+	{
+		static const std::unordered_map<std::string_view, u64> s_link_table
+		{
+			{"get_timebased_time", reinterpret_cast<u64>(&get_timebased_time)},
+			{"spu_check_interrupts", reinterpret_cast<u64>(&exec_check_interrupts)},
+			{"spu_dispatch", reinterpret_cast<u64>(spu_runtime::tr_dispatch)},
+			{"spu_dispatcher", reinterpret_cast<u64>(spu_runtime::tr_all)},
+			{"spu_escape", reinterpret_cast<u64>(spu_runtime::g_escape)},
+			{"spu_exec_check_state", reinterpret_cast<u64>(&exec_check_state)},
+			{"spu_exec_mfc_cmd", reinterpret_cast<u64>(&exec_mfc_cmd)},
+			{"spu_get_events", reinterpret_cast<u64>(&exec_get_events)},
+			{"spu_interp_check", reinterpret_cast<u64>(&interp_check)},
+			{"spu_list_unstall", reinterpret_cast<u64>(&exec_list_unstall)},
+			{"spu_memcpy", reinterpret_cast<u64>(&exec_memcpy)},
+			{"spu_read_channel", reinterpret_cast<u64>(&exec_rdch)},
+			{"spu_read_channel_count", reinterpret_cast<u64>(&exec_rchcnt)},
+			{"spu_read_decrementer", reinterpret_cast<u64>(&exec_read_dec)},
+			{"spu_read_events", reinterpret_cast<u64>(&exec_read_events)},
+			{"spu_read_in_mbox", reinterpret_cast<u64>(&exec_read_in_mbox)},
+			{"spu_rotqby", reinterpret_cast<u64>(&exec_rotqby)},
+			{"spu_syscall", reinterpret_cast<u64>(&exec_stop)},
+			{"spu_unknown", reinterpret_cast<u64>(&exec_unk)},
+			{"spu_write_channel", reinterpret_cast<u64>(&exec_wrch)},
+		};
+
+		const auto found = s_link_table.find(name);
+		return found == s_link_table.end() ? 0 : found->second;
+	}
+
+	// Get list of external symbols of the module if all of them can be relinked without IR
+	std::optional<std::string> get_link_list(const llvm::Module& _module)
+	{
+		std::string result;
+
+		for (const auto& f : _module.functions())
+		{
+			if (!f.isDeclaration() || f.isIntrinsic() || f.use_empty())
+			{
+				continue;
+			}
+
+			const std::string name = f.getName().str();
+
+			if (!name.starts_with(m_hash + "-pp-") && !name.starts_with(m_hash + "-chunkpp-0x"))
+			{
+				// Must match the address actually used for compilation
+				if (const u64 addr = get_link_address(name); !addr || addr != m_engine->getAddressToGlobalIfAvailable(name))
+				{
+					spu_log.warning("[%s] Cannot relink symbol '%s', persistent object will be rebuilt", m_hash, name);
+					return std::nullopt;
+				}
+			}
+
+			result += name;
+			result += '\n';
+		}
+
+		return result;
+	}
+
+	// Link persistent object compiled earlier (returns nullptr if not possible)
+	spu_function_t load_object(const std::string& obj_path)
+	{
+		const fs::file link_file(obj_path + m_hash + ".link");
+
+		if (!link_file || !jit_compiler::check(obj_path + m_hash + ".obj"))
+		{
+			return nullptr;
+		}
+
+		const auto names = fmt::split(link_file.to_string(), {"\n"});
+
+		// Validate symbol list before creating any patchpoints
+		for (const std::string& name : names)
+		{
+			if (!name.starts_with(m_hash + "-pp-") && !name.starts_with(m_hash + "-chunkpp-0x") && !get_link_address(name))
+			{
+				spu_log.error("[%s] Unknown symbol '%s' in persistent object link list", m_hash, name);
+				return nullptr;
+			}
+		}
+
+		m_engine->clearAllGlobalMappings();
+
+		for (const std::string& name : names)
+		{
+			if (name.starts_with(m_hash + "-pp-"))
+			{
+				m_engine->updateGlobalMapping(name, reinterpret_cast<u64>(m_spurt->make_branch_patchpoint()));
+			}
+			else if (name.starts_with(m_hash + "-chunkpp-0x"))
+			{
+				const u32 addr = static_cast<u32>(std::stoul(name.substr(m_hash.size() + 11), nullptr, 16));
+				m_engine->updateGlobalMapping(name, reinterpret_cast<u64>(m_spurt->make_branch_patchpoint(addr / 4)));
+			}
+			else
+			{
+				m_engine->updateGlobalMapping(name, get_link_address(name));
+			}
+		}
+
+		m_jit.add(obj_path + m_hash + ".obj");
+		m_jit.fin();
+
+		return reinterpret_cast<spu_function_t>(m_jit.get(m_hash));
+	}
+
 public:
 	spu_llvm_recompiler(u8 interp_magn = 0)
 		: spu_recompiler_base()
@@ -4256,20 +4658,23 @@ public:
 			cache.add(func);
 		}
 
-		{
-			sha1_context ctx;
-			u8 output[20];
+		m_hash = spu_runtime::get_obj_name(func, &m_hash_start);
 
-			sha1_starts(&ctx);
-			sha1_update(&ctx, reinterpret_cast<const u8*>(func.data.data()), func.data.size() * 4);
-			sha1_finish(&ctx, output);
+		if (const auto& obj_path = m_spurt->get_obj_path(); !obj_path.empty())
+		{
+			// Link persistent object directly if possible, IR is not built
+			if (const spu_function_t fn = load_object(obj_path))
+			{
+				add_loc->compiled = fn;
 
-			m_hash.clear();
-			fmt::append(m_hash, "spu-0x%05x-%s", func.entry_point, fmt::base57(output));
+				if (!m_spurt->rebuild_ubertrampoline(func.data[0]))
+				{
+					return nullptr;
+				}
 
-			be_t<u64> hash_start;
-			std::memcpy(&hash_start, output, sizeof(hash_start));
-			m_hash_start = hash_start;
+				add_loc->compiled.notify_all();
+				return fn;
+			}
 		}
 
 		spu_log.notice("Building function 0x%x... (size %u, %s)", func.entry_point, func.data.size(), m_hash);
@@ -4821,6 +5226,18 @@ public:
 			// Testing only
 			m_jit.add(std::move(_module), m_spurt->get_cache_path() + "llvm/");
 		}
+		else if (const auto& obj_path = m_spurt->get_obj_path(); !obj_path.empty())
+		{
+			// List external symbols, allows to link the object later without building IR
+			if (const auto link_list = get_link_list(*_module))
+			{
+				fs::file(obj_path + m_hash + ".link", fs::rewrite).write(*link_list);
+			}
+
+			// Remove damaged object if necessary, load existing one or save compiled one
+			jit_compiler::check(obj_path + m_hash + ".obj");
+			m_jit.add(std::move(_module), obj_path);
+		}
 		else
 		{
 			m_jit.add(std::move(_module));
@@ -5669,6 +6086,11 @@ public:
 		set_vr(op.rt, insert(splat<u32[4]>(0), 3, res));
 	}
 
+	static void exec_memcpy(u8* dst, const u8* src, u32 size)
+	{
+		std::memcpy(dst, src, size);
+	}
+
 	static void exec_wrch(spu_thread* _spu, u32 ch, u32 value)
 	{
 		if (!_spu->set_ch_value(ch, value))
@@ -6012,11 +6434,7 @@ public:
 					else if (csize)
 					{
 						// TODO
-						auto spu_memcpy = [](u8* dst, const u8* src, u32 size)
-						{
-							std::memcpy(dst, src, size);
-						};
-						call("spu_memcpy", +spu_memcpy, dst, src, zext<u32>(size).eval(m_ir));
+						call("spu_memcpy", &exec_memcpy, dst, src, zext<u32>(size).eval(m_ir));
 					}
 
 					// Disable certain thing
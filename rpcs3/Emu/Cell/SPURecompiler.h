@@ -71,6 +71,13 @@ public:
 	// Ubertrampoline generated for this item when it was latest
 	atomic_t<spu_function_t> trampoline = nullptr;
 
+	// Number of calls through the ubertrampoline (counted only with SPU profiler)
+	atomic_t<u64> hits = 0;
+
+	// Call counting stub and its target (created only with SPU profiler)
+	atomic_t<spu_function_t> counted = nullptr;
+	atomic_t<spu_function_t> counted_target = nullptr;
+
 	atomic_t<u8> cached = false;
 	atomic_t<u8> logged = false;
 
@@ -93,6 +100,14 @@ class spu_runtime
 	// Debug module output location
 	std::string m_cache_path;
 
+	// Persistent compiled object location (empty if disabled)
+	std::string m_obj_path;
+
+	// Dispatch statistics
+	atomic_t<u64> m_dispatch_misses = 0;
+	atomic_t<u64> m_branch_misses = 0;
+	atomic_t<u64> m_rebuilds = 0;
+
 public:
 	// Trampoline to spu_recompiler_base::dispatch
 	static const spu_function_t tr_dispatch;
@@ -109,6 +124,8 @@ public:
 public:
 	spu_runtime();
 
+	~spu_runtime();
+
 	spu_runtime(const spu_runtime&) = delete;
 
 	spu_runtime& operator=(const spu_runtime&) = delete;
@@ -118,12 +135,38 @@ public:
 		return m_cache_path;
 	}
 
+	const std::string& get_obj_path() const
+	{
+		return m_obj_path;
+	}
+
+	// Get object name for the program (without extension, also used as the function name)
+	static std::string get_obj_name(const spu_program& func, u64* hash_start = nullptr);
+
 	// Rebuild ubertrampoline for given identifier (first instruction)
 	spu_function_t rebuild_ubertrampoline(u32 id_inst);
 
+	// Count calls of spu_recompiler_base::dispatch (no matching function)
+	void count_dispatch_miss()
+	{
+		m_dispatch_misses++;
+	}
+
+	// Count calls of spu_recompiler_base::branch (unresolved patchpoint)
+	void count_branch_miss()
+	{
+		m_branch_misses++;
+	}
+
+	// Get statistics: {dispatch misses, branch misses, trampoline rebuilds, trampoline hits}
+	std::array<u64, 4> get_stats() const;
+
 private:
 	friend class spu_cache;
 
+	// Generate a trampoline which counts calls of the item
+	static spu_function_t make_counting_stub(spu_item& item, spu_function_t target);
+
 public:
 	// Return new pointer for add()
 	spu_item* add_empty(spu_program&&);
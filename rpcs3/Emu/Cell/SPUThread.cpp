@@ -4404,7 +4404,7 @@ bool spu_thread::stop_and_signal(u32 code)
 				return ch_in_mbox.set_values(1, CELL_EINVAL), true;
 			}
 
-			if (queue->events.empty())
+			if (queue->events.try_wait())
 			{
 				queue->sq.emplace_back(this);
 				group->run_state = SPU_THREAD_GROUP_STATUS_WAITING;
@@ -4423,12 +4423,12 @@ bool spu_thread::stop_and_signal(u32 code)
 			else
 			{
 				// Return the event immediately
-				const auto event = queue->events.front();
+				lv2_event event;
+				ensure(queue->events.try_pop(event));
 				const auto data1 = static_cast<u32>(std::get<1>(event));
 				const auto data2 = static_cast<u32>(std::get<2>(event));
 				const auto data3 = static_cast<u32>(std::get<3>(event));
 				ch_in_mbox.set_values(4, CELL_OK, data1, data2, data3);
-				queue->events.pop_front();
 				return true;
 			}
 		}
@@ -4523,17 +4523,17 @@ bool spu_thread::stop_and_signal(u32 code)
 			return ch_in_mbox.set_values(1, CELL_EINVAL), true;
 		}
 
-		if (queue->events.empty())
+		lv2_event event;
+
+		if (!queue->events.try_pop(event))
 		{
 			return ch_in_mbox.set_values(1, CELL_EBUSY), true;
 		}
 
-		const auto event = queue->events.front();
 		const auto data1 = static_cast<u32>(std::get<1>(event));
 		const auto data2 = static_cast<u32>(std::get<2>(event));
 		const auto data3 = static_cast<u32>(std::get<3>(event));
 		ch_in_mbox.set_values(4, CELL_OK, data1, data2, data3);
-		queue->events.pop_front();
 		return true;
 	}
 
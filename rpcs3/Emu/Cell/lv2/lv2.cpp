@@ -1118,6 +1118,37 @@ namespace cpu_counter
 	void remove(cpu_thread*) noexcept;
 }
 
+namespace
+{
+	// g_ppu is sorted by priority (FIFO within the same priority), g_waiting is sorted by timeout
+	struct ppu_prio_less
+	{
+		bool operator()(const ppu_thread* ppu, s32 prio) const
+		{
+			return ppu->prio < prio;
+		}
+
+		bool operator()(s32 prio, const ppu_thread* ppu) const
+		{
+			return prio < ppu->prio;
+		}
+	};
+}
+
+bool lv2_obj::unqueue_ppu(cpu_thread* cpu, s32 prio)
+{
+	// Only threads of the same priority need to be checked
+	const auto [begin, end] = std::equal_range(g_ppu.begin(), g_ppu.end(), prio, ppu_prio_less{});
+
+	if (const auto found = std::find(begin, end, cpu); found != end)
+	{
+		g_ppu.erase(found);
+		return true;
+	}
+
+	return false;
+}
+
 void lv2_obj::sleep(cpu_thread& cpu, const u64 timeout)
 {
 	vm::temporary_unlock(cpu);
@@ -1165,7 +1196,7 @@ void lv2_obj::sleep_unlocked(cpu_thread& thread, u64 timeout)
 		}
 
 		// Find and remove the thread
-		if (!unqueue(g_ppu, ppu))
+		if (!unqueue_ppu(ppu, ppu->prio))
 		{
 			// Already sleeping
 			ppu_log.trace("sleep(): called on already sleeping thread.");
@@ -1182,15 +1213,13 @@ void lv2_obj::sleep_unlocked(cpu_thread& thread, u64 timeout)
 	{
 		const u64 wait_until = start_time + timeout;
 
-		// Register timeout if necessary
-		for (auto it = g_waiting.cbegin(), end = g_waiting.cend();; it++)
+		// Register timeout if necessary, after entries with the same timeout
+		const auto it = std::upper_bound(g_waiting.cbegin(), g_waiting.cend(), wait_until, [](u64 value, const std::pair<u64, cpu_thread*>& entry)
 		{
-			if (it == end || it->first > wait_until)
-			{
-				g_waiting.emplace(it, wait_until, &thread);
-				break;
-			}
-		}
+			return value < entry.first;
+		});
+
+		g_waiting.emplace(it, wait_until, &thread);
 	}
 
 	if (!g_to_awake.empty())
@@ -1214,7 +1243,7 @@ bool lv2_obj::awake_unlocked(cpu_thread* cpu, s32 prio)
 	default:
 	{
 		// Priority set
-		if (static_cast<ppu_thread*>(cpu)->prio.exchange(prio) == prio || !unqueue(g_ppu, cpu))
+		if (const s32 old_prio = static_cast<ppu_thread*>(cpu)->prio.exchange(prio); old_prio == prio || !unqueue_ppu(cpu, old_prio))
 		{
 			return true;
 		}
@@ -1273,22 +1302,18 @@ bool lv2_obj::awake_unlocked(cpu_thread* cpu, s32 prio)
 
 	const auto emplace_thread = [](cpu_thread* const cpu)
 	{
-		for (auto it = g_ppu.cbegin(), end = g_ppu.cend();; it++)
-		{
-			if (it != end && *it == cpu)
-			{
-				ppu_log.trace("sleep() - suspended (p=%zu)", g_pending.size());
-				return false;
-			}
+		const s32 prio = static_cast<ppu_thread*>(cpu)->prio;
+		const auto [begin, end] = std::equal_range(g_ppu.begin(), g_ppu.end(), prio, ppu_prio_less{});
 
-			// Use priority, also preserve FIFO order
-			if (it == end || (*it)->prio > static_cast<ppu_thread*>(cpu)->prio)
-			{
-				g_ppu.insert(it, static_cast<ppu_thread*>(cpu));
-				break;
-			}
+		if (std::find(begin, end, cpu) != end)
+		{
+			ppu_log.trace("sleep() - suspended (p=%zu)", g_pending.size());
+			return false;
 		}
 
+		// Use priority, also preserve FIFO order
+		g_ppu.insert(end, static_cast<ppu_thread*>(cpu));
+
 		// Unregister timeout if necessary
 		for (auto it = g_waiting.cbegin(), end = g_waiting.cend(); it != end; it++)
 		{
@@ -1371,19 +1396,24 @@ void lv2_obj::schedule_all()
 	}
 
 	// Check registered timeouts
-	while (!g_waiting.empty())
+	if (!g_waiting.empty())
 	{
-		auto& pair = g_waiting.front();
+		const u64 current_time = get_guest_system_time();
 
-		if (pair.first <= get_guest_system_time())
+		while (!g_waiting.empty())
 		{
-			pair.second->notify();
-			g_waiting.pop_front();
-		}
-		else
-		{
-			// The list is sorted so assume no more timeouts
-			break;
+			auto& pair = g_waiting.front();
+
+			if (pair.first <= current_time)
+			{
+				pair.second->notify();
+				g_waiting.pop_front();
+			}
+			else
+			{
+				// The list is sorted so assume no more timeouts
+				break;
+			}
 		}
 	}
 }
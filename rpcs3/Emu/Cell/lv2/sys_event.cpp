@@ -9,6 +9,9 @@
 #include "Emu/Cell/SPUThread.h"
 #include "sys_process.h"
 
+#include "util/asm.hpp"
+#include "util/sysinfo.hpp"
+
 LOG_CHANNEL(sys_event);
 
 template<> DECLARE(ipc_manager<lv2_event_queue, u64>::g_ipc) {};
@@ -43,8 +46,118 @@ bool lv2_event_queue::check(const std::shared_ptr<lv2_event_queue>& sptr)
 	return sptr && sptr->exists;
 }
 
+lv2_event_ring::push_result lv2_event_ring::try_push(const lv2_event& event, u32 max_size)
+{
+	const auto [old, ok] = m_ctrl.fetch_op([&](ctrl_t& ctrl)
+	{
+		if (ctrl.waiters || ctrl.count >= max_size)
+		{
+			return false;
+		}
+
+		ctrl.count++;
+		return true;
+	});
+
+	if (!ok)
+	{
+		return old.waiters ? push_result::has_waiters : push_result::full;
+	}
+
+	// The slot cannot be in use: the consumer never lags more than max_size positions behind
+	const u32 pos = old.head + old.count;
+	auto& slot = m_slots[pos % capacity];
+	slot.event = event;
+	slot.seq.release(pos + 1);
+	return push_result::stored;
+}
+
+bool lv2_event_ring::try_pop(lv2_event& out)
+{
+	const auto [old, ok] = m_ctrl.fetch_op([](ctrl_t& ctrl)
+	{
+		if (!ctrl.count)
+		{
+			return false;
+		}
+
+		ctrl.head++;
+		ctrl.count--;
+		return true;
+	});
+
+	if (!ok)
+	{
+		return false;
+	}
+
+	auto& slot = m_slots[old.head % capacity];
+
+	// Wait for the producer to finish writing (it may have been preempted)
+	for (u32 i = 0; slot.seq.load() != old.head + 1; i++)
+	{
+		if (i < 100)
+		{
+			utils::pause();
+		}
+		else
+		{
+			std::this_thread::yield();
+		}
+	}
+
+	out = slot.event;
+	return true;
+}
+
+bool lv2_event_ring::try_wait()
+{
+	return m_ctrl.fetch_op([](ctrl_t& ctrl)
+	{
+		if (ctrl.count)
+		{
+			return false;
+		}
+
+		ctrl.waiters++;
+		return true;
+	}).second;
+}
+
+void lv2_event_ring::remove_waiter()
+{
+	m_ctrl.atomic_op([](ctrl_t& ctrl)
+	{
+		ctrl.waiters--;
+	});
+}
+
+void lv2_event_ring::clear()
+{
+	for (lv2_event event; try_pop(event);)
+	{
+	}
+}
+
 CellError lv2_event_queue::send(lv2_event event)
 {
+	if (!exists)
+	{
+		return CELL_ENOTCONN;
+	}
+
+	// Fast path: nobody is waiting, store the event without locking
+	switch (events.try_push(event, size))
+	{
+	case lv2_event_ring::push_result::stored:
+	{
+		// The queue may have been destroyed after the check above (the event is lost with it)
+		return exists ? CellError{} : CELL_ENOTCONN;
+	}
+	case lv2_event_ring::push_result::full: return CELL_EBUSY;
+	case lv2_event_ring::push_result::has_waiters: break;
+	}
+
 	std::lock_guard lock(mutex);
 
 	if (!exists)
@@ -54,16 +167,12 @@ CellError lv2_event_queue::send(lv2_event event)
 
 	if (sq.empty())
 	{
-		if (events.size() < this->size + 0u)
-		{
-			// Save event
-			events.emplace_back(event);
-			return {};
-		}
-
-		return CELL_EBUSY;
+		// The waiter is gone (timed out), no new waiters can appear while locked
+		return events.try_push(event, size) == lv2_event_ring::push_result::stored ? CellError{} : CELL_EBUSY;
 	}
 
+	events.remove_waiter();
+
 	if (type == SYS_PPU_QUEUE)
 	{
 		// Store event in registers
@@ -246,11 +355,11 @@ error_code sys_event_queue_tryreceive(ppu_thread& ppu, u32 equeue_id, vm::ptr<sy
 
 	s32 count = 0;
 
-	while (queue->sq.empty() && count < size && !queue->events.empty())
+	lv2_event event;
+
+	while (queue->sq.empty() && count < size && queue->events.try_pop(event))
 	{
 		auto& dest = event_array[count++];
-		const auto event = queue->events.front();
-		queue->events.pop_front();
 
 		std::tie(dest.source, dest.data1, dest.data2, dest.data3) = event;
 	}
@@ -268,6 +377,18 @@ error_code sys_event_queue_receive(ppu_thread& ppu, u32 equeue_id, vm::ptr<sys_e
 
 	ppu.gpr[3] = CELL_OK;
 
+	if (utils::get_thread_count() > 1)
+	{
+		// Poll for a short time before sleeping: an event stored meanwhile is taken without involving the scheduler
+		if (const auto queue = idm::get<lv2_obj, lv2_event_queue>(equeue_id); queue && queue->type == SYS_PPU_QUEUE)
+		{
+			for (u32 i = 0; i < 1000 && !queue->events.size(); i++)
+			{
+				utils::pause();
+			}
+		}
+	}
+
 	const auto queue = idm::get<lv2_obj, lv2_event_queue>(equeue_id, [&](lv2_event_queue& queue) -> CellError
 	{
 		if (queue.type != SYS_PPU_QUEUE)
@@ -277,15 +398,16 @@ error_code sys_event_queue_receive(ppu_thread& ppu, u32 equeue_id, vm::ptr<sys_e
 
 		std::lock_guard lock(queue.mutex);
 
-		if (queue.events.empty())
+		if (queue.events.try_wait())
 		{
 			queue.sq.emplace_back(&ppu);
 			queue.sleep(ppu, timeout);
 			return CELL_EBUSY;
 		}
 
-		std::tie(ppu.gpr[4], ppu.gpr[5], ppu.gpr[6], ppu.gpr[7]) = queue.events.front();
-		queue.events.pop_front();
+		lv2_event event;
+		ensure(queue.events.try_pop(event));
+		std::tie(ppu.gpr[4], ppu.gpr[5], ppu.gpr[6], ppu.gpr[7]) = event;
 		return {};
 	});
 
@@ -331,6 +453,8 @@ error_code sys_event_queue_receive(ppu_thread& ppu, u32 equeue_id, vm::ptr<sys_e
 					break;
 				}
 
+				queue->events.remove_waiter();
+
 				ppu.gpr[3] = CELL_ETIMEDOUT;
 				break;
 			}
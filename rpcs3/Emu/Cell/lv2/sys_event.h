@@ -75,6 +75,54 @@ struct sys_event_t
 // Source, data1, data2, data3
 using lv2_event = std::tuple<u64, u64, u64, u64>;
 
+// Bounded event storage: lock-free push from any thread, pop and waiter registration are serialized by the queue mutex
+class lv2_event_ring
+{
+	struct alignas(8) ctrl_t
+	{
+		u32 head; // Position of the oldest event
+		u16 count; // Reserved events (some may still be written)
+		u16 waiters; // Number of receivers in the sleep queue
+	};
+
+	struct slot_t
+	{
+		atomic_t<u32> seq; // Position + 1 after the event is written
+		lv2_event event;
+	};
+
+	static constexpr u32 capacity = 128; // Must exceed max queue size (127)
+
+	atomic_t<ctrl_t> m_ctrl{};
+	std::array<slot_t, capacity> m_slots{};
+
+public:
+	enum class push_result : u32
+	{
+		stored,
+		has_waiters,
+		full,
+	};
+
+	// Store event unless there are waiting receivers or no space left
+	push_result try_push(const lv2_event& event, u32 max_size);
+
+	// Take the oldest event
+	bool try_pop(lv2_event& out);
+
+	// Register a waiting receiver if no events are stored
+	bool try_wait();
+
+	void remove_waiter();
+
+	void clear();
+
+	usz size() const
+	{
+		return m_ctrl.load().count;
+	}
+};
+
 struct lv2_event_queue final : public lv2_obj
 {
 	static const u32 id_base = 0x8d000000;
@@ -87,8 +135,8 @@ struct lv2_event_queue final : public lv2_obj
 
 	atomic_t<u32> exists = 0; // Existence validation (workaround for shared-ptr ref-counting)
 	shared_mutex mutex;
-	std::deque<lv2_event> events;
-	std::deque<cpu_thread*> sq;
+	lv2_event_ring events;
+	std::deque<cpu_thread*> sq; // Protected by mutex, its size is mirrored in events
 
 	lv2_event_queue(u32 protocol, s32 type, u64 name, u64 ipc_key, s32 size)
 		: protocol{protocol}
@@ -7,7 +7,10 @@
 #include "Emu/System.h"
 #include "Emu/VFS.h"
 #include "Emu/IdManager.h"
+#include "Emu/system_config.h"
 #include "Utilities/StrUtil.h"
+#include "Utilities/Thread.h"
+#include "util/asm.hpp"
 
 LOG_CHANNEL(sys_fs);
 
@@ -130,13 +133,35 @@ lv2_fs_mount_point* lv2_fs_object::get_mp(std::string_view filename)
 
 u64 lv2_file::op_read(const fs::file& file, vm::ptr<void> buf, u64 size)
 {
-	// Copy data from intermediate buffer (avoid passing vm pointer to a native API)
+	// Read straight into guest memory if the whole range is mapped and writable (native files only)
+	// Host-protected pages (e.g. locked by the texture cache) make the native read fail or stop early,
+	// the following block is then copied through the intermediate buffer to trigger the access handler
+	const bool direct = size <= 0xffff'ffff && vm::check_addr(buf.addr(), vm::page_writable, static_cast<u32>(size));
+
 	uchar local_buf[65536];
 
 	u64 result = 0;
 
 	while (result < size)
 	{
+		if (direct)
+		{
+			const u64 block = std::min<u64>(size - result, 0x1000000);
+			const u64 nread = file.try_read_native(static_cast<uchar*>(buf.get_ptr()) + result, block);
+
+			if (nread != umax)
+			{
+				result += nread;
+
+				if (nread == block)
+				{
+					continue;
+				}
+			}
+
+			// End of file is also detected below
+		}
+
 		const u64 block = std::min<u64>(size - result, sizeof(local_buf));
 		const u64 nread = file.read(+local_buf, block);
 
@@ -154,13 +179,31 @@ u64 lv2_file::op_read(const fs::file& file, vm::ptr<void> buf, u64 size)
 
 u64 lv2_file::op_write(const fs::file& file, vm::cptr<void> buf, u64 size)
 {
-	// Copy data to intermediate buffer (avoid passing vm pointer to a native API)
+	// Write straight from guest memory if the whole range is mapped and readable (see op_read)
+	const bool direct = size <= 0xffff'ffff && vm::check_addr(buf.addr(), vm::page_readable, static_cast<u32>(size));
+
 	uchar local_buf[65536];
 
 	u64 result = 0;
 
 	while (result < size)
 	{
+		if (direct)
+		{
+			const u64 block = std::min<u64>(size - result, 0x1000000);
+			const u64 nwrite = file.try_write_native(static_cast<const uchar*>(buf.get_ptr()) + result, block);
+
+			if (nwrite != umax)
+			{
+				result += nwrite;
+
+				if (nwrite == block)
+				{
+					continue;
+				}
+			}
+		}
+
 		const u64 block = std::min<u64>(size - result, sizeof(local_buf));
 		std::memcpy(local_buf, static_cast<const uchar*>(buf.get_ptr()) + result, block);
 		const u64 nwrite = file.write(+local_buf, block);
@@ -175,6 +218,223 @@ u64 lv2_file::op_write(const fs::file& file, vm::cptr<void> buf, u64 size)
 	return result;
 }
 
+// Prefetched data of a sequentially read file, filled by the read-ahead thread with a separate file handle
+struct lv2_file_readahead
+{
+	static constexpr u64 min_chunk = 0x40000;
+	static constexpr u64 max_chunk = 0x400000;
+
+	struct chunk_t
+	{
+		u64 pos = 0;
+		u64 size = 0;
+		std::vector<u8> data;
+
+		// 0: empty, 1: pending, 2: ready
+		atomic_t<u32> state = 0;
+	};
+
+	// Own handle, the position of the guest file is never touched
+	fs::file file;
+
+	chunk_t chunks[2];
+
+	// Sequential access detection (under the mount point lock)
+	u64 next_pos = 0;
+	u32 streak = 0;
+	bool disabled = false;
+};
+
+struct lv2_fs_readahead_thread
+{
+	lf_queue<std::pair<std::shared_ptr<lv2_file_readahead>, u32>> registered;
+
+	atomic_t<u64> hit_bytes = 0;
+	atomic_t<u64> miss_bytes = 0;
+	atomic_t<u64> prefetched_bytes = 0;
+
+	void operator()()
+	{
+		for (auto slice = registered.pop_all();; [&]
+		{
+			if (slice)
+			{
+				slice.pop_front();
+			}
+
+			if (slice || thread_ctrl::state() == thread_state::aborting)
+			{
+				return;
+			}
+
+			thread_ctrl::wait_on(registered, nullptr);
+			slice = registered.pop_all();
+		}())
+		{
+			if (thread_ctrl::state() == thread_state::aborting)
+			{
+				break;
+			}
+
+			auto* req = slice.get();
+
+			if (!req)
+			{
+				continue;
+			}
+
+			auto& chunk = req->first->chunks[req->second];
+			auto& file = req->first->file;
+
+			chunk.data.resize(chunk.size);
+
+			if (file.seek(chunk.pos) == chunk.pos)
+			{
+				chunk.data.resize(file.read(chunk.data.data(), chunk.size));
+			}
+			else
+			{
+				chunk.data.clear();
+			}
+
+			prefetched_bytes += chunk.data.size();
+
+			chunk.state.release(2);
+			chunk.state.notify_all();
+		}
+
+		if (const u64 hits = hit_bytes, misses = miss_bytes; hits || misses)
+		{
+			sys_fs.notice("Read-ahead: %u MiB prefetched, %u MiB hit, %u MiB missed (hit rate %.1f%%)", prefetched_bytes / (1024 * 1024), hits / (1024 * 1024), misses / (1024 * 1024), hits * 100. / (hits + misses));
+		}
+	}
+
+	static constexpr auto thread_name = "FS Read-Ahead"sv;
+};
+
+using lv2_fs_readahead = named_thread<lv2_fs_readahead_thread>;
+
+u64 lv2_file::op_read(vm::ptr<void> buf, u64 size)
+{
+	// Only files on read-only mounts: writes through other handles would leave prefetched chunks stale
+	if (!size || type != lv2_file_type::regular || !(mp->flags & lv2_mp_flag::read_only) || !g_cfg.vfs.fs_readahead)
+	{
+		return op_read(file, buf, size);
+	}
+
+	if (!readahead)
+	{
+		readahead = std::make_shared<lv2_file_readahead>();
+	}
+
+	auto& ra = *readahead;
+	auto& thread = g_fxo->get<lv2_fs_readahead>();
+
+	const u64 pos = file.pos();
+
+	ra.streak = pos == ra.next_pos ? ra.streak + 1 : 0;
+
+	u64 result = 0;
+
+	// Copy prefetched data, waiting for a pending chunk if it covers the position
+	for (bool found = true; found && result < size;)
+	{
+		found = false;
+
+		for (auto& chunk : ra.chunks)
+		{
+			const u64 cur = pos + result;
+
+			if (!chunk.state || cur < chunk.pos || cur >= chunk.pos + chunk.size)
+			{
+				continue;
+			}
+
+			while (chunk.state == 1u && !Emu.IsStopped())
+			{
+				chunk.state.wait(1, atomic_wait_timeout{100'000'000});
+			}
+
+			if (chunk.state != 2u || cur >= chunk.pos + chunk.data.size())
+			{
+				break;
+			}
+
+			const u64 count = std::min<u64>(size - result, chunk.pos + chunk.data.size() - cur);
+			std::memcpy(static_cast<u8*>(buf.get_ptr()) + result, chunk.data.data() + (cur - chunk.pos), count);
+			result += count;
+			found = true;
+			break;
+		}
+	}
+
+	if (result)
+	{
+		thread.hit_bytes += result;
+		file.seek(pos + result);
+	}
+
+	if (result < size)
+	{
+		const u64 nread = op_read(file, vm::ptr<void>::make(buf.addr() + static_cast<u32>(result)), size - result);
+		thread.miss_bytes += nread;
+		result += nread;
+	}
+
+	ra.next_pos = pos + result;
+
+	if (ra.streak < 2 || result < size || ra.disabled)
+	{
+		return result;
+	}
+
+	// Sequential stream: keep up to one chunk prefetched past the data already available or pending
+	const u64 chunk_size = std::clamp<u64>(utils::align<u64>(size * 4, 0x10000), ra.min_chunk, ra.max_chunk);
+
+	u64 ahead = ra.next_pos;
+
+	for (u32 i = 0; i < 2; i++)
+	{
+		for (auto& chunk : ra.chunks)
+		{
+			if (chunk.state && ahead >= chunk.pos && ahead < chunk.pos + chunk.size)
+			{
+				ahead = chunk.pos + chunk.size;
+			}
+		}
+	}
+
+	if (ahead - ra.next_pos >= chunk_size)
+	{
+		return result;
+	}
+
+	for (u32 i = 0; i < 2; i++)
+	{
+		auto& chunk = ra.chunks[i];
+
+		// Reuse empty chunks, or ready chunks which are not ahead of the stream
+		if (chunk.state == 1u || (chunk.state == 2u && chunk.pos + chunk.size > ra.next_pos && chunk.pos <= ahead))
+		{
+			continue;
+		}
+
+		if (!ra.file && !ra.file.open(real_path))
+		{
+			ra.disabled = true;
+			break;
+		}
+
+		chunk.pos = ahead;
+		chunk.size = chunk_size;
+		chunk.state.release(1);
+		thread.registered.push(readahead, i);
+		break;
+	}
+
+	return result;
+}
+
 struct lv2_file::file_view : fs::file_base
 {
 	const std::shared_ptr<lv2_file> m_file;
@@ -197,6 +197,8 @@ struct lv2_fs_object
 	virtual std::string to_string() const { return {}; }
 };
 
+struct lv2_file_readahead;
+
 struct lv2_file final : lv2_fs_object
 {
 	fs::file file;
@@ -208,6 +210,9 @@ struct lv2_file final : lv2_fs_object
 	// Stream lock
 	atomic_t<u32> lock{0};
 
+	// Background read-ahead state (created on demand)
+	std::shared_ptr<lv2_file_readahead> readahead;
+
 	// Some variables for convinience of data restoration
 	struct save_restore_t
 	{
@@ -258,10 +263,8 @@ struct lv2_file final : lv2_fs_object
 	// File reading with intermediate buffer
 	static u64 op_read(const fs::file& file, vm::ptr<void> buf, u64 size);
 
-	u64 op_read(vm::ptr<void> buf, u64 size) const
-	{
-		return op_read(file, buf, size);
-	}
+	// File reading with read-ahead for sequential streams
+	u64 op_read(vm::ptr<void> buf, u64 size);
 
 	// File writing with intermediate buffer
 	static u64 op_write(const fs::file& file, vm::cptr<void> buf, u64 size);
@@ -153,6 +153,9 @@ private:
 	// Schedule the thread
 	static bool awake_unlocked(cpu_thread*, s32 prio = enqueue_cmd);
 
+	// Remove the thread from g_ppu, prio must be the priority it was queued with
+	static bool unqueue_ppu(cpu_thread*, s32 prio);
+
 public:
 	static constexpr u64 max_timeout = UINT64_MAX / 1000;
 
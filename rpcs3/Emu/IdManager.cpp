@@ -6,6 +6,114 @@ shared_mutex id_manager::g_mutex;
 
 thread_local DECLARE(idm::g_id);
 
+thread_local DECLARE(id_manager::g_tls_hazard) = nullptr;
+
+namespace id_manager
+{
+	// List of all hazard pointers, never shrinks (entries are reused)
+	static atomic_t<hazard_pointer*> g_hazards{};
+
+	// Records removed while possibly being read (protected by g_mutex)
+	static std::vector<const id_record*> g_retired;
+
+	// Hazard pointer values collected by reclaim() (protected by g_mutex, reused)
+	static std::vector<const id_record*> g_hazards_scratch;
+
+	// Size of g_retired which triggers reclaim() (protected by g_mutex)
+	static usz g_reclaim_threshold = 64;
+
+	// Returns the hazard pointer to the list on thread exit
+	struct hazard_owner
+	{
+		~hazard_owner()
+		{
+			if (g_tls_hazard)
+			{
+				g_tls_hazard->ptr.release(nullptr);
+				g_tls_hazard->used.release(0);
+				g_tls_hazard = nullptr;
+			}
+		}
+	};
+
+	static thread_local hazard_owner s_tls_hazard_owner;
+}
+
+id_manager::hazard_pointer* id_manager::acquire_hazard()
+{
+	// Register thread exit handler
+	[[maybe_unused]] auto& owner = s_tls_hazard_owner;
+
+	for (auto ptr = g_hazards.load(); ptr; ptr = ptr->next)
+	{
+		if (!ptr->used && ptr->used.compare_and_swap_test(0, 1))
+		{
+			return g_tls_hazard = ptr;
+		}
+	}
+
+	const auto ptr = new hazard_pointer;
+	ptr->used.raw() = 1;
+	ptr->next = g_hazards.load();
+
+	while (!g_hazards.compare_exchange(ptr->next, ptr))
+	{
+	}
+
+	return g_tls_hazard = ptr;
+}
+
+void id_manager::retire(const id_record* rec)
+{
+	if (!rec)
+	{
+		return;
+	}
+
+	g_retired.push_back(rec);
+
+	// Amortize the hazard scan
+	if (g_retired.size() >= g_reclaim_threshold)
+	{
+		reclaim();
+	}
+}
+
+void id_manager::reclaim()
+{
+	if (g_retired.empty())
+	{
+		return;
+	}
+
+	g_hazards_scratch.clear();
+
+	for (auto ptr = g_hazards.load(); ptr; ptr = ptr->next)
+	{
+		if (const auto value = ptr->ptr.load())
+		{
+			g_hazards_scratch.push_back(value);
+		}
+	}
+
+	std::sort(g_hazards_scratch.begin(), g_hazards_scratch.end());
+
+	// Delete records which aren't protected by any thread
+	std::erase_if(g_retired, [&](const id_record* rec)
+	{
+		if (std::binary_search(g_hazards_scratch.begin(), g_hazards_scratch.end(), rec))
+		{
+			return false;
+		}
+
+		delete rec;
+		return true;
+	});
+
+	// Records still protected don't count towards the next scan
+	g_reclaim_threshold = g_retired.size() + 64;
+}
+
 idm::map_data* idm::allocate_id(std::vector<map_data>& vec, u32 type_id,  u32 base, u32 step, u32 count, std::pair<u32, u32> invl_range)
 {
 	if (vec.size() < count)
@@ -138,17 +138,71 @@ namespace id_manager
 		}
 	};
 
+	// Immutable copy of an ID entry published for lock-free lookups
+	struct id_record
+	{
+		id_key key;
+		void* ptr;
+		std::weak_ptr<void> weak; // Delayed reclamation must not prolong the object lifetime
+	};
+
+	// Protects the id_record being read by the owning thread from reclamation
+	struct alignas(64) hazard_pointer
+	{
+		atomic_t<const id_record*> ptr{};
+		atomic_t<u32> used{};
+		hazard_pointer* next{};
+	};
+
+	extern thread_local hazard_pointer* g_tls_hazard;
+
+	hazard_pointer* acquire_hazard();
+
+	inline hazard_pointer& get_hazard()
+	{
+		if (!g_tls_hazard) [[unlikely]]
+		{
+			return *acquire_hazard();
+		}
+
+		return *g_tls_hazard;
+	}
+
+	// Delete the record once no thread is reading it (g_mutex must be locked)
+	void retire(const id_record* rec);
+
+	// Delete retired records which are no longer read (g_mutex must be locked)
+	void reclaim();
+
 	template <typename T>
 	struct id_map
 	{
 		std::vector<std::pair<id_key, std::shared_ptr<void>>> vec;
+		std::unique_ptr<atomic_t<const id_record*>[]> slots; // Lock-free view of vec, indexed the same way
 		shared_mutex mutex; // TODO: Use this instead of global mutex
 
 		id_map()
+			: slots(new atomic_t<const id_record*>[T::id_count]{})
 		{
 			// Preallocate memory
 			vec.reserve(T::id_count);
 		}
+
+		id_map(const id_map&) = delete;
+
+		id_map& operator=(const id_map&) = delete;
+
+		~id_map()
+		{
+			std::lock_guard lock(g_mutex);
+
+			for (u32 i = 0; i < T::id_count; i++)
+			{
+				retire(slots[i].exchange(nullptr));
+			}
+
+			reclaim();
+		}
 	};
 }
 
@@ -303,6 +357,80 @@ class idm
 		return nullptr;
 	}
 
+	// Update the lock-free view of the entry (g_mutex must be locked)
+	template <typename T>
+	static void publish(map_data* data)
+	{
+		auto& map = g_fxo->get<id_manager::id_map<T>>();
+
+		const usz index = data - map.vec.data();
+
+		if (index >= T::id_count)
+		{
+			// Not addressable, lookups take the locked path
+			return;
+		}
+
+		const id_manager::id_record* rec = nullptr;
+
+		if (data->second)
+		{
+			rec = new id_manager::id_record{data->first, data->second.get(), data->second};
+		}
+
+		id_manager::retire(map.slots[index].exchange(rec));
+	}
+
+	// Find the published record without locking and pass it to func (nullptr if not found)
+	template <typename T, typename Type, typename F>
+	static auto lookup(u32 id, F&& func)
+	{
+		static_assert(id_manager::id_verify<T, Type>::value, "Invalid ID type combination");
+
+		const u32 index = get_index<Type>(id);
+
+		auto& slot = g_fxo->get<id_manager::id_map<T>>().slots[index];
+		auto& hazard = id_manager::get_hazard().ptr;
+
+		// Protect the record, retry if it has been replaced meanwhile
+		auto rec = slot.load();
+
+		while (true)
+		{
+			hazard = rec;
+
+			if (const auto cur = slot.load(); cur != rec)
+			{
+				rec = cur;
+				continue;
+			}
+
+			break;
+		}
+
+		if (rec && !std::is_same_v<T, Type> && rec->key.type() != get_type<Type>())
+		{
+			rec = nullptr;
+		}
+
+		if (rec && id_manager::id_traits<Type>::invl_range.second && rec->key.value() != id)
+		{
+			rec = nullptr;
+		}
+
+		auto result = func(rec);
+		hazard.release(nullptr);
+		return result;
+	}
+
+	// Check if the lookup can use the lock-free view
+	template <typename T, typename Type>
+	static bool is_addressable(u32 id)
+	{
+		const u32 index = get_index<Type>(id);
+		return index < id_manager::id_traits<Type>::count && index < T::id_count;
+	}
+
 	// Allocate new ID and assign the object from the provider()
 	template <typename T, typename Type, typename F>
 	static map_data* create_id(F&& provider)
@@ -324,6 +452,7 @@ class idm
 
 			if (place->second)
 			{
+				publish<T>(place);
 				return place;
 			}
 		}
@@ -338,7 +467,16 @@ public:
 	static inline void clear()
 	{
 		std::lock_guard lock(id_manager::g_mutex);
-		g_fxo->get<id_manager::id_map<T>>().vec.clear();
+
+		auto& map = g_fxo->get<id_manager::id_map<T>>();
+
+		for (u32 i = 0; i < T::id_count; i++)
+		{
+			id_manager::retire(map.slots[i].exchange(nullptr));
+		}
+
+		id_manager::reclaim();
+		map.vec.clear();
 	}
 
 	// Get last ID (updated in create_id/allocate_id)
@@ -414,13 +552,21 @@ public:
 		return nullptr;
 	}
 
-	// Check the ID
+	// Check the ID (lock-free)
 	template <typename T, typename Get = T>
 	static inline Get* check(u32 id)
 	{
-		reader_lock lock(id_manager::g_mutex);
+		if (!is_addressable<T, Get>(id)) [[unlikely]]
+		{
+			reader_lock lock(id_manager::g_mutex);
 
-		return check_unlocked<T, Get>(id);
+			return check_unlocked<T, Get>(id);
+		}
+
+		return lookup<T, Get>(id, [](const id_manager::id_record* rec)
+		{
+			return rec ? static_cast<Get*>(rec->ptr) : nullptr;
+		});
 	}
 
 	// Check the ID, access object under shared lock
@@ -466,20 +612,27 @@ public:
 		return std::static_pointer_cast<Get>(found->second);
 	}
 
-	// Get the object
+	// Get the object (lock-free)
 	template <typename T, typename Get = T>
 	static inline std::shared_ptr<Get> get(u32 id)
 	{
-		reader_lock lock(id_manager::g_mutex);
+		if (!is_addressable<T, Get>(id)) [[unlikely]]
+		{
+			reader_lock lock(id_manager::g_mutex);
 
-		const auto found = find_id<T, Get>(id);
+			return get_unlocked<T, Get>(id);
+		}
 
-		if (found == nullptr) [[unlikely]]
+		return lookup<T, Get>(id, [](const id_manager::id_record* rec) -> std::shared_ptr<Get>
 		{
-			return nullptr;
-		}
+			if (!rec)
+			{
+				return nullptr;
+			}
 
-		return std::static_pointer_cast<Get>(found->second);
+			// Fails if the object is being destroyed after removal
+			return std::static_pointer_cast<Get>(rec->weak.lock());
+		});
 	}
 
 	// Get the object, access object under reader lock
@@ -572,6 +725,7 @@ public:
 			if (const auto found = find_id<T, Get>(id))
 			{
 				ptr = std::move(found->second);
+				publish<T>(found);
 			}
 			else
 			{
@@ -594,6 +748,7 @@ public:
 				(!found->second.owner_before(sptr) && !sptr.owner_before(found->second)))
 			{
 				ptr = std::move(found->second);
+				publish<T>(found);
 			}
 			else
 			{
@@ -615,6 +770,7 @@ public:
 			if (const auto found = find_id<T, Get>(id))
 			{
 				ptr = std::static_pointer_cast<Get>(::as_rvalue(std::move(found->second)));
+				publish<T>(found);
 			}
 		}
 
@@ -634,7 +790,9 @@ public:
 			if constexpr (std::is_void_v<FRT>)
 			{
 				func(*_ptr);
-				return std::static_pointer_cast<Get>(::as_rvalue(std::move(found->second)));
+				auto ptr = std::static_pointer_cast<Get>(::as_rvalue(std::move(found->second)));
+				publish<T>(found);
+				return ptr;
 			}
 			else
 			{
@@ -646,7 +804,9 @@ public:
 					return {{found->second, _ptr}, std::move(ret)};
 				}
 
-				return {std::static_pointer_cast<Get>(::as_rvalue(std::move(found->second))), std::move(ret)};
+				auto ptr = std::static_pointer_cast<Get>(::as_rvalue(std::move(found->second)));
+				publish<T>(found);
+				return {std::move(ptr), std::move(ret)};
 			}
 		}
 
@@ -7,34 +7,62 @@
 #include "Emu/RSX/RSXThread.h"
 #include "Emu/Memory/vm.h"
 
+#include "util/fnv_hash.hpp"
+
 #include "xxhash.h"
 
 namespace rsx
 {
 	namespace capture
 	{
-		void insert_mem_block_in_map(std::unordered_set<u64>& mem_changes, frame_capture_data::memory_block&& block, frame_capture_data::memory_block_data&& data)
+		// Store memory contents as deduplicated page-sized chunks (split on guest page boundaries),
+		// so identical data and unchanged pages across draws and frames are only stored once
+		void insert_mem_block_in_map(std::unordered_set<u64>& mem_changes, frame_capture_data::memory_block&& block, const u8* src, usz size, u32 addr)
 		{
-			if (!data.data.empty())
+			if (!size)
+			{
+				return;
+			}
+
+			constexpr u32 page_size = frame_capture_data::memory_page_size;
+
+			frame_capture_data::memory_block_data data;
+			data.size = ::narrow<u32>(size);
+
+			usz data_hash = rpcs3::hash64(rpcs3::fnv_seed, data.size);
+
+			for (usz pos = 0; pos < size;)
 			{
-				u64 data_hash = XXH64(data.data.data(), data.data.size(), 0);
-				block.data_state = data_hash;
+				const usz chunk = std::min<usz>(size - pos, page_size - (addr + pos) % page_size);
+				const u64 page_hash = XXH64(src + pos, chunk, 0);
 
-				auto it = frame_capture.memory_data_map.find(data_hash);
-				if (it != frame_capture.memory_data_map.end())
+				if (auto [it, inserted] = frame_capture.memory_page_map.try_emplace(page_hash); inserted)
 				{
-					if (it->second.data != data.data)
-						// screw this
-						fmt::throw_exception("Memory map hash collision detected...cant capture");
+					it->second.assign(src + pos, src + pos + chunk);
+				}
+				else if (it->second.size() != chunk || std::memcmp(it->second.data(), src + pos, chunk) != 0)
+				{
+					// screw this
+					fmt::throw_exception("Memory map hash collision detected...cant capture");
 				}
-				else
-					frame_capture.memory_data_map.insert(std::make_pair(data_hash, std::move(data)));
 
-				u64 block_hash = XXH64(&block, sizeof(frame_capture_data::memory_block), 0);
-				mem_changes.insert(block_hash);
-				if (frame_capture.memory_map.find(block_hash) == frame_capture.memory_map.end())
-					frame_capture.memory_map.insert(std::make_pair(block_hash, std::move(block)));
+				data.pages.push_back(page_hash);
+				data_hash = rpcs3::hash64(data_hash, page_hash);
+				pos += chunk;
 			}
+
+			block.data_state = data_hash;
+
+			// Pages are verified above, so equal page lists mean equal contents
+			if (auto [it, inserted] = frame_capture.memory_data_map.try_emplace(data_hash, std::move(data)); !inserted &&
+				(it->second.size != data.size || it->second.pages != data.pages))
+			{
+				fmt::throw_exception("Memory block hash collision detected...cant capture");
+			}
+
+			const u64 block_hash = XXH64(&block, sizeof(frame_capture_data::memory_block), 0);
+			mem_changes.insert(block_hash);
+			frame_capture.memory_map.try_emplace(block_hash, std::move(block));
 		}
 
 		void capture_draw_memory(thread* rsx)
@@ -61,10 +89,7 @@ namespace rsx
 			frame_capture_data::memory_block block;
 			block.offset = program_offset;
 			block.location = program_location;
-			frame_capture_data::memory_block_data block_data;
-			block_data.data.resize(ucode_size + program_start);
-			std::memcpy(block_data.data.data(), vm::base(addr), ucode_size + program_start);
-			insert_mem_block_in_map(mem_changes, std::move(block), std::move(block_data));
+			insert_mem_block_in_map(mem_changes, std::move(block), vm::_ptr<u8>(addr), ucode_size + program_start, addr);
 
 			// vertex shader is passed in registers, so it can be ignored
 
@@ -88,10 +113,7 @@ namespace rsx
 				frame_capture_data::memory_block block;
 				block.offset = tex.offset();
 				block.location = tex.location();
-				frame_capture_data::memory_block_data block_data;
-				block_data.data.resize(texSize);
-				std::memcpy(block_data.data.data(), vm::base(texaddr), texSize);
-				insert_mem_block_in_map(mem_changes, std::move(block), std::move(block_data));
+				insert_mem_block_in_map(mem_changes, std::move(block), vm::_ptr<u8>(texaddr), texSize, texaddr);
 			}
 
 			// save vertex texture mem
@@ -114,10 +136,7 @@ namespace rsx
 				frame_capture_data::memory_block block;
 				block.offset = tex.offset();
 				block.location = tex.location();
-				frame_capture_data::memory_block_data block_data;
-				block_data.data.resize(texSize);
-				std::memcpy(block_data.data.data(), vm::base(texaddr), texSize);
-				insert_mem_block_in_map(mem_changes, std::move(block), std::move(block_data));
+				insert_mem_block_in_map(mem_changes, std::move(block), vm::_ptr<u8>(texaddr), texSize, texaddr);
 			}
 
 			// save vertex buffer memory
@@ -152,10 +171,7 @@ namespace rsx
 						frame_capture_data::memory_block block;
 						block.offset = base_address + (range.first * vertStride);
 						block.location = memory_location;
-						frame_capture_data::memory_block_data block_data;
-						block_data.data.resize(bufferSize);
-						std::memcpy(block_data.data.data(), vm::base(addr + (range.first * vertStride)), bufferSize);
-						insert_mem_block_in_map(mem_changes, std::move(block), std::move(block_data));
+						insert_mem_block_in_map(mem_changes, std::move(block), vm::_ptr<u8>(addr + (range.first * vertStride)), bufferSize, addr + (range.first * vertStride));
 					}
 					while (method_registers.current_draw_clause.next());
 				}
@@ -191,10 +207,7 @@ namespace rsx
 					frame_capture_data::memory_block block;
 					block.offset = base_address + (idxFirst * type_size);
 					block.location = memory_location;
-					frame_capture_data::memory_block_data block_data;
-					block_data.data.resize(bufferSize);
-					std::memcpy(block_data.data.data(), vm::base(idxAddr), bufferSize);
-					insert_mem_block_in_map(mem_changes, std::move(block), std::move(block_data));
+					insert_mem_block_in_map(mem_changes, std::move(block), vm::_ptr<u8>(idxAddr), bufferSize, idxAddr);
 
 					switch (index_type)
 					{
@@ -254,10 +267,7 @@ namespace rsx
 						frame_capture_data::memory_block block;
 						block.offset = base_address + (min_index * vertStride);
 						block.location = memory_location;
-						frame_capture_data::memory_block_data block_data;
-						block_data.data.resize(bufferSize);
-						std::memcpy(block_data.data.data(), vm::base(addr + (min_index * vertStride)), bufferSize);
-						insert_mem_block_in_map(mem_changes, std::move(block), std::move(block_data));
+						insert_mem_block_in_map(mem_changes, std::move(block), vm::_ptr<u8>(addr + (min_index * vertStride)), bufferSize, addr + (min_index * vertStride));
 					}
 				}
 			}
@@ -301,15 +311,11 @@ namespace rsx
 			block.location = src_dma & 0xf;
 
 			const auto src_address = rsx::get_address(block.offset, block.location);
-			u8* pixels_src = vm::_ptr<u8>(src_address);
 
 			const u32 src_size = in_pitch * (in_h - 1) + (in_w * in_bpp);
 			rsx->read_barrier(src_address, src_size, true);
 
-			frame_capture_data::memory_block_data block_data;
-			block_data.data.resize(src_size);
-			std::memcpy(block_data.data.data(), pixels_src, src_size);
-			insert_mem_block_in_map(replay_command.memory_state, std::move(block), std::move(block_data));
+			insert_mem_block_in_map(replay_command.memory_state, std::move(block), vm::_ptr<u8>(src_address), src_size, src_address);
 
 			capture_display_tile_state(rsx, replay_command);
 		}
@@ -332,16 +338,15 @@ namespace rsx
 			frame_capture_data::memory_block block;
 			block.offset = src_offset;
 			block.location = src_dma;
-			frame_capture_data::memory_block_data block_data;
-			block_data.data.resize(in_pitch * (line_count - 1) + line_length);
+			std::vector<u8> block_data(in_pitch * (line_count - 1) + line_length);
 
 			for (u32 i = 0; i < line_count; ++i)
 			{
-				std::memcpy(block_data.data.data() + (line_length * i), src, line_length);
+				std::memcpy(block_data.data() + (line_length * i), src, line_length);
 				src += in_pitch;
 			}
 
-			insert_mem_block_in_map(replay_command.memory_state, std::move(block), std::move(block_data));
+			insert_mem_block_in_map(replay_command.memory_state, std::move(block), block_data.data(), block_data.size(), src_addr);
 			capture_display_tile_state(rsx, replay_command);
 		}
 
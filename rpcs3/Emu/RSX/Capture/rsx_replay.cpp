@@ -7,9 +7,135 @@
 #include "Emu/RSX/RSXThread.h"
 
 #include "util/asm.hpp"
+#include "util/cereal.hpp"
 
 namespace rsx
 {
+	bool frame_capture_file::open(const std::string& path)
+	{
+		if (!m_file.open(path))
+		{
+			return false;
+		}
+
+		m_size = m_file.size();
+
+		frame_capture_header header{};
+
+		if (!m_file.read(header) || header.magic != FRAME_CAPTURE_MAGIC)
+		{
+			rsx_log.error("Invalid rsx capture file!");
+			return false;
+		}
+
+		if (header.version != FRAME_CAPTURE_VERSION)
+		{
+			rsx_log.error("Rsx capture file version not supported! Expected %d, found %d", FRAME_CAPTURE_VERSION, header.version);
+			return false;
+		}
+
+		std::string index;
+
+		if (header.index_offset > m_size || header.index_size > m_size - header.index_offset || m_file.seek(header.index_offset) != header.index_offset || !m_file.read(index, header.index_size))
+		{
+			rsx_log.error("Rsx capture file is truncated!");
+			return false;
+		}
+
+		frame = std::make_unique<frame_capture_data>();
+		cereal_deserialize(*frame, index);
+
+		if (frame->magic != FRAME_CAPTURE_MAGIC || frame->version != FRAME_CAPTURE_VERSION)
+		{
+			rsx_log.error("Invalid rsx capture file index!");
+			return false;
+		}
+
+		// Memory blocks are not loaded upfront
+		m_view = std::make_unique<utils::file_view>(m_file);
+
+		if (!m_view->get())
+		{
+			rsx_log.warning("Failed to map rsx capture file, memory blocks will be read on demand");
+		}
+
+		rsx_log.notice("Loaded rsx capture: %u commands, %u memory blocks, %u memory pages (%u KiB index)", frame->replay_commands.size(), frame->memory_data_map.size(), frame->memory_data_index.size(), header.index_size / 1024);
+		return true;
+	}
+
+	const u8* frame_capture_file::get_block(u64 page_hash, u64& size)
+	{
+		const auto found = frame->memory_data_index.find(page_hash);
+
+		if (found == frame->memory_data_index.end())
+		{
+			return nullptr;
+		}
+
+		const auto& loc = found->second;
+
+		if (loc.offset > m_size || loc.size > m_size - loc.offset)
+		{
+			fmt::throw_exception("Capture Replay: memory block out of file bounds (offset=0x%llx, size=0x%llx)", loc.offset, loc.size);
+		}
+
+		size = loc.size;
+
+		if (const u8* base = m_view->get())
+		{
+			return base + loc.offset;
+		}
+
+		m_buffer.resize(loc.size);
+
+		if (m_file.seek(loc.offset) != loc.offset || m_file.read(m_buffer.data(), loc.size) != loc.size)
+		{
+			fmt::throw_exception("Capture Replay: failed to read memory block (offset=0x%llx, size=0x%llx)", loc.offset, loc.size);
+		}
+
+		return m_buffer.data();
+	}
+
+	bool frame_capture_file::write(const std::string& path, frame_capture_data& data)
+	{
+		fs::pending_file temp(path);
+
+		if (!temp.file)
+		{
+			return false;
+		}
+
+		frame_capture_header header{FRAME_CAPTURE_MAGIC, FRAME_CAPTURE_VERSION, 0, 0};
+		temp.file.write(header);
+
+		// Memory page payloads
+		u64 pos = sizeof(header);
+		data.memory_data_index.clear();
+
+		for (const auto& [hash, page] : data.memory_page_map)
+		{
+			const u64 offset = utils::align<u64>(pos, 16);
+			temp.file.seek(offset);
+			temp.file.write(page);
+
+			data.memory_data_index.emplace(hash, frame_capture_data::memory_block_location{offset, page.size()});
+			pos = offset + page.size();
+		}
+
+		// Index (everything else)
+		const std::string index = cereal_serialize(data);
+
+		header.index_offset = utils::align<u64>(pos, 16);
+		header.index_size = index.size();
+		temp.file.seek(header.index_offset);
+		temp.file.write(index);
+
+		temp.file.seek(0);
+		temp.file.write(header);
+
+		return temp.commit(false);
+	}
+
 	be_t<u32> rsx_replay_thread::allocate_context()
 	{
 		u32 buffer_size = 4;
@@ -108,12 +234,23 @@ namespace rsx
 				fmt::throw_exception("requested memory state for command not found in memory_map");
 
 			const auto& memblock = it->second;
-			auto it_data = frame->memory_data_map.find(it->second.data_state);
-			if (it_data == frame->memory_data_map.end())
+			auto data_it = frame->memory_data_map.find(memblock.data_state);
+			if (data_it == frame->memory_data_map.end())
 				fmt::throw_exception("requested memory data state for command not found in memory_data_map");
 
-			const auto& data_block = it_data->second;
-			std::memcpy(vm::base(get_address(memblock.offset, memblock.location)), data_block.data.data(), data_block.data.size());
+			u8* dst = vm::_ptr<u8>(get_address(memblock.offset, memblock.location));
+			u64 pos = 0;
+
+			for (u64 page_hash : data_it->second.pages)
+			{
+				u64 size = 0;
+				const u8* data = capture->get_block(page_hash, size);
+				if (!data || pos + size > data_it->second.size)
+					fmt::throw_exception("requested memory page for command not found in memory_data_index");
+
+				std::memcpy(dst + pos, data, size);
+				pos += size;
+			}
 		}
 
 		if (replay_cmd.display_buffer_state != 0 && replay_cmd.display_buffer_state != cs.display_buffer_hash)
@@ -2,6 +2,7 @@
 
 #include "Emu/CPU/CPUThread.h"
 #include "Emu/RSX/rsx_methods.h"
+#include "util/vm.hpp"
 
 #include <unordered_map>
 #include <unordered_set>
@@ -9,16 +10,48 @@
 namespace rsx
 {
 	constexpr u32 FRAME_CAPTURE_MAGIC = 0x52524300; // ascii 'RRC/0'
-	constexpr u32 FRAME_CAPTURE_VERSION = 0x4;
+	constexpr u32 FRAME_CAPTURE_VERSION = 0x6;
+
+	// Capture file layout: header, memory page payloads (16-byte aligned), then the serialized
+	// frame_capture_data as an index, with memory pages referenced by their location in the file
+	struct frame_capture_header
+	{
+		u32 magic;
+		u32 version;
+		u64 index_offset;
+		u64 index_size;
+	};
+
 	struct frame_capture_data
 	{
+		// memory pages are split on guest page boundaries and stored once per unique content
+		static constexpr u32 memory_page_size = 4096;
+
+		// memory block contents as a list of page hashes
 		struct memory_block_data
 		{
-			std::vector<u8> data;
+			std::vector<u64> pages;
+			u32 size;
+
+			template<typename Archive>
+			void serialize(Archive& ar)
+			{
+				ar(pages);
+				ar(size);
+			}
+		};
+
+		// location of a memory page payload in the capture file
+		struct memory_block_location
+		{
+			u64 offset;
+			u64 size;
+
 			template<typename Archive>
 			void serialize(Archive& ar)
 			{
-				ar(data);
+				ar(offset);
+				ar(size);
 			}
 		};
 
@@ -145,6 +178,10 @@ namespace rsx
 		std::unordered_map<u64, memory_block> memory_map;
 		// hashmap of memory blocks that can be applied, this is split from above for size decrease
 		std::unordered_map<u64, memory_block_data> memory_data_map;
+		// hashmap of unique memory page contents, only used while capturing (not serialized)
+		std::unordered_map<u64, std::vector<u8>> memory_page_map;
+		// hashmap of memory page payload locations in the capture file
+		std::unordered_map<u64, memory_block_location> memory_data_index;
 		// display buffer state map
 		std::unordered_map<u64, display_buffers_state> display_buffers_map;
 		// actual command queue to hold everything above
@@ -160,6 +197,7 @@ namespace rsx
 			ar(tile_map);
 			ar(memory_map);
 			ar(memory_data_map);
+			ar(memory_data_index);
 			ar(display_buffers_map);
 			ar(replay_commands);
 			ar(reg_state);
@@ -171,12 +209,37 @@ namespace rsx
 			version = FRAME_CAPTURE_VERSION;
 			tile_map.clear();
 			memory_map.clear();
+			memory_data_map.clear();
+			memory_page_map.clear();
+			memory_data_index.clear();
+			display_buffers_map.clear();
 			replay_commands.clear();
 			reg_state = method_registers;
 		}
 	};
 
 
+	// Capture file opened for replay, memory block payloads are mapped or read on demand
+	class frame_capture_file
+	{
+		fs::file m_file;
+		u64 m_size = 0;
+		std::unique_ptr<utils::file_view> m_view;
+		std::vector<u8> m_buffer;
+
+	public:
+		std::unique_ptr<frame_capture_data> frame;
+
+		// Load the header and the index
+		bool open(const std::string& path);
+
+		// Get memory page payload, the pointer is valid until the next call
+		const u8* get_block(u64 page_hash, u64& size);
+
+		// Write capture file, payloads of memory_page_map are stored outside of the index
+		static bool write(const std::string& path, frame_capture_data& data);
+	};
+
 	class rsx_replay_thread : public cpu_thread
 	{
 		struct rsx_context
@@ -201,12 +264,14 @@ namespace rsx
 
 		u32 user_mem_addr;
 		current_state cs;
-		std::unique_ptr<frame_capture_data> frame;
+		std::unique_ptr<frame_capture_file> capture;
+		frame_capture_data* frame;
 
 	public:
-		rsx_replay_thread(std::unique_ptr<frame_capture_data>&& frame_data)
+		rsx_replay_thread(std::unique_ptr<frame_capture_file>&& capture_file)
 			: cpu_thread(0)
-			, frame(std::move(frame_data))
+			, capture(std::move(capture_file))
+			, frame(capture->frame.get())
 		{
 		}
 
@@ -42,6 +42,20 @@ SSE4_1_FUNC static inline u16 sse41_hmax_epu16(__m128i x)
 	return ~_mm_cvtsi128_si32(_mm_minpos_epu16(_mm_xor_si128(x, _mm_set1_epi32(-1))));
 }
 
+SSE4_1_FUNC static inline u32 sse41_hmin_epu32(__m128i x)
+{
+	x = _mm_min_epu32(x, _mm_srli_si128(x, 8));
+	x = _mm_min_epu32(x, _mm_srli_si128(x, 4));
+	return _mm_cvtsi128_si32(x);
+}
+
+SSE4_1_FUNC static inline u32 sse41_hmax_epu32(__m128i x)
+{
+	x = _mm_max_epu32(x, _mm_srli_si128(x, 8));
+	x = _mm_max_epu32(x, _mm_srli_si128(x, 4));
+	return _mm_cvtsi128_si32(x);
+}
+
 const bool s_use_ssse3 = utils::has_ssse3();
 const bool s_use_sse4_1 = utils::has_sse41();
 const bool s_use_avx2 = utils::has_avx2();
@@ -780,6 +794,73 @@ namespace
 			return std::make_tuple(min_index, max_index, count);
 		}
 
+		AVX2_FUNC
+		static
+		std::tuple<u16, u16, u32> upload_u16_swapped_avx2(const void *src, void *dst, u32 count)
+		{
+			const __m256i mask = _mm256_broadcastsi128_si256(_mm_set_epi8(
+				0xE, 0xF, 0xC, 0xD,
+				0xA, 0xB, 0x8, 0x9,
+				0x6, 0x7, 0x4, 0x5,
+				0x2, 0x3, 0x0, 0x1));
+
+			auto src_stream = static_cast<const __m256i*>(src);
+			auto dst_stream = static_cast<__m256i*>(dst);
+
+			__m256i min = _mm256_set1_epi16(-1);
+			__m256i max = _mm256_set1_epi16(0);
+
+			const auto iterations = count / 16;
+			for (unsigned n = 0; n < iterations; ++n)
+			{
+				const __m256i raw = _mm256_loadu_si256(src_stream++);
+				const __m256i value = _mm256_shuffle_epi8(raw, mask);
+				max = _mm256_max_epu16(max, value);
+				min = _mm256_min_epu16(min, value);
+				_mm256_storeu_si256(dst_stream++, value);
+			}
+
+			const __m128i min2 = _mm_min_epu16(_mm256_castsi256_si128(min), _mm256_extracti128_si256(min, 1));
+			const __m128i max2 = _mm_max_epu16(_mm256_castsi256_si128(max), _mm256_extracti128_si256(max, 1));
+
+			const u16 min_index = sse41_hmin_epu16(min2);
+			const u16 max_index = sse41_hmax_epu16(max2);
+
+			return std::make_tuple(min_index, max_index, count);
+		}
+
+		AVX2_FUNC
+		static
+		std::tuple<u32, u32, u32> upload_u32_swapped_avx2(const void *src, void *dst, u32 count)
+		{
+			const __m256i mask = _mm256_broadcastsi128_si256(_mm_set_epi8(
+				0xC, 0xD, 0xE, 0xF,
+				0x8, 0x9, 0xA, 0xB,
+				0x4, 0x5, 0x6, 0x7,
+				0x0, 0x1, 0x2, 0x3));
+
+			auto src_stream = static_cast<const __m256i*>(src);
+			auto dst_stream = static_cast<__m256i*>(dst);
+
+			__m256i min = _mm256_set1_epi32(~0u);
+			__m256i max = _mm256_set1_epi32(0);
+
+			const auto iterations = count / 8;
+			for (unsigned n = 0; n < iterations; ++n)
+			{
+				const __m256i raw = _mm256_loadu_si256(src_stream++);
+				const __m256i value = _mm256_shuffle_epi8(raw, mask);
+				max = _mm256_max_epu32(max, value);
+				min = _mm256_min_epu32(min, value);
+				_mm256_storeu_si256(dst_stream++, value);
+			}
+
+			const u32 min_index = sse41_hmin_epu32(_mm_min_epu32(_mm256_castsi256_si128(min), _mm256_extracti128_si256(min, 1)));
+			const u32 max_index = sse41_hmax_epu32(_mm_max_epu32(_mm256_castsi256_si128(max), _mm256_extracti128_si256(max, 1)));
+
+			return std::make_tuple(min_index, max_index, count);
+		}
+
 		template<typename T>
 		static
 		std::tuple<T, T, u32> upload_untouched(gsl::span<to_be_t<const T>> src, gsl::span<T> dst)
@@ -788,7 +869,26 @@ namespace
 			u32 written;
 			u32 remaining = ::size32(src);
 
-			if (s_use_sse4_1 && remaining >= 32)
+			if (s_use_avx2 && remaining >= 32)
+			{
+				if constexpr (std::is_same<T, u32>::value)
+				{
+					const auto count = (remaining & ~0x7);
+					std::tie(min_index, max_index, written) = upload_u32_swapped_avx2(src.data(), dst.data(), count);
+				}
+				else if constexpr (std::is_same<T, u16>::value)
+				{
+					const auto count = (remaining & ~0xF);
+					std::tie(min_index, max_index, written) = upload_u16_swapped_avx2(src.data(), dst.data(), count);
+				}
+				else
+				{
+					fmt::throw_exception("Unreachable");
+				}
+
+				remaining -= written;
+			}
+			else if (s_use_sse4_1 && remaining >= 32)
 			{
 				if constexpr (std::is_same<T, u32>::value)
 				{
@@ -953,6 +1053,41 @@ namespace
 			return std::make_tuple(min_index, max_index);
 		}
 
+		AVX2_FUNC
+		static
+		std::tuple<u32, u32> upload_u32_swapped_avx2(const void *src, void *dst, u32 iterations, u32 restart_index)
+		{
+			const __m256i shuffle_mask = _mm256_broadcastsi128_si256(_mm_set_epi8(
+				0xC, 0xD, 0xE, 0xF,
+				0x8, 0x9, 0xA, 0xB,
+				0x4, 0x5, 0x6, 0x7,
+				0x0, 0x1, 0x2, 0x3));
+
+			auto src_stream = static_cast<const __m256i*>(src);
+			auto dst_stream = static_cast<__m256i*>(dst);
+
+			__m256i restart = _mm256_set1_epi32(restart_index);
+			__m256i min = _mm256_set1_epi32(0xffffffff);
+			__m256i max = _mm256_set1_epi32(0);
+
+			for (unsigned n = 0; n < iterations; ++n)
+			{
+				const __m256i raw = _mm256_loadu_si256(src_stream++);
+				const __m256i value = _mm256_shuffle_epi8(raw, shuffle_mask);
+				const __m256i mask = _mm256_cmpeq_epi32(restart, value);
+				const __m256i value_with_min_restart = _mm256_andnot_si256(mask, value);
+				const __m256i value_with_max_restart = _mm256_or_si256(mask, value);
+				max = _mm256_max_epu32(max, value_with_min_restart);
+				min = _mm256_min_epu32(min, value_with_max_restart);
+				_mm256_storeu_si256(dst_stream++, value_with_max_restart);
+			}
+
+			const u32 min_index = sse41_hmin_epu32(_mm_min_epu32(_mm256_castsi256_si128(min), _mm256_extracti128_si256(min, 1)));
+			const u32 max_index = sse41_hmax_epu32(_mm_max_epu32(_mm256_castsi256_si128(max), _mm256_extracti128_si256(max, 1)));
+
+			return std::make_tuple(min_index, max_index);
+		}
+
 		template<typename T>
 		static
 		std::tuple<T, T, u32> upload_untouched(gsl::span<to_be_t<const T>> src, gsl::span<T> dst, T restart_index, bool skip_restart)
@@ -981,7 +1116,13 @@ namespace
 				}
 				else if constexpr (std::is_same<T, u32>::value)
 				{
-					if (s_use_sse4_1)
+					if (s_use_avx2)
+					{
+						u32 iterations = length >> 3;
+						written = length & ~0x7;
+						std::tie(min_index, max_index) = upload_u32_swapped_avx2(src.data(), dst.data(), iterations, restart_index);
+					}
+					else if (s_use_sse4_1)
 					{
 						u32 iterations = length >> 2;
 						written = length & ~0x3;
@@ -1014,6 +1155,329 @@ namespace
 		}
 	};
 
+	// Fused byteswap, min/max and expansion of quads and triangle fans.
+	// Kernels stop at the first block containing a primitive restart index and return the number of source indices consumed.
+	struct expansion_impl
+	{
+		AVX2_FUNC
+		static
+		std::tuple<u16, u16, u32> expand_quads_u16_avx2(const void *src, void *dst, u32 count, bool check_restart, u16 restart_index)
+		{
+			const __m256i swap_mask = _mm256_broadcastsi128_si256(_mm_set_epi8(
+				0xE, 0xF, 0xC, 0xD, 0xA, 0xB, 0x8, 0x9, 0x6, 0x7, 0x4, 0x5, 0x2, 0x3, 0x0, 0x1));
+
+			// Swap and expand {0, 1, 2, 3, 4, 5, 6, 7} to {0, 1, 2, 2, 3, 0, 4, 5} and {6, 6, 7, 4}
+			const __m256i expand_mask0 = _mm256_broadcastsi128_si256(_mm_set_epi8(
+				0xA, 0xB, 0x8, 0x9, 0x0, 0x1, 0x6, 0x7, 0x4, 0x5, 0x4, 0x5, 0x2, 0x3, 0x0, 0x1));
+			const __m256i expand_mask1 = _mm256_broadcastsi128_si256(_mm_set_epi8(
+				-1, -1, -1, -1, -1, -1, -1, -1, 0x8, 0x9, 0xE, 0xF, 0xC, 0xD, 0xC, 0xD));
+
+			auto src_ptr = static_cast<const u16*>(src);
+			auto dst_ptr = static_cast<u16*>(dst);
+
+			const __m256i restart = _mm256_set1_epi16(restart_index);
+			__m256i min = _mm256_set1_epi16(-1);
+			__m256i max = _mm256_set1_epi16(0);
+
+			u32 consumed = 0;
+			for (; consumed + 16 <= count; consumed += 16, src_ptr += 16, dst_ptr += 24)
+			{
+				const __m256i raw = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src_ptr));
+				const __m256i value = _mm256_shuffle_epi8(raw, swap_mask);
+
+				if (check_restart && _mm256_movemask_epi8(_mm256_cmpeq_epi16(value, restart)))
+				{
+					break;
+				}
+
+				max = _mm256_max_epu16(max, value);
+				min = _mm256_min_epu16(min, value);
+
+				const __m256i out0 = _mm256_shuffle_epi8(raw, expand_mask0);
+				const __m256i out1 = _mm256_shuffle_epi8(raw, expand_mask1);
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(dst_ptr), _mm256_castsi256_si128(out0));
+				_mm_storel_epi64(reinterpret_cast<__m128i*>(dst_ptr + 8), _mm256_castsi256_si128(out1));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(dst_ptr + 12), _mm256_extracti128_si256(out0, 1));
+				_mm_storel_epi64(reinterpret_cast<__m128i*>(dst_ptr + 20), _mm256_extracti128_si256(out1, 1));
+			}
+
+			const __m128i min2 = _mm_min_epu16(_mm256_castsi256_si128(min), _mm256_extracti128_si256(min, 1));
+			const __m128i max2 = _mm_max_epu16(_mm256_castsi256_si128(max), _mm256_extracti128_si256(max, 1));
+
+			return std::make_tuple(sse41_hmin_epu16(min2), sse41_hmax_epu16(max2), consumed);
+		}
+
+		SSE4_1_FUNC
+		static
+		std::tuple<u16, u16, u32> expand_quads_u16_sse4_1(const void *src, void *dst, u32 count, bool check_restart, u16 restart_index)
+		{
+			const __m128i swap_mask = _mm_set_epi8(
+				0xE, 0xF, 0xC, 0xD, 0xA, 0xB, 0x8, 0x9, 0x6, 0x7, 0x4, 0x5, 0x2, 0x3, 0x0, 0x1);
+			const __m128i expand_mask0 = _mm_set_epi8(
+				0xA, 0xB, 0x8, 0x9, 0x0, 0x1, 0x6, 0x7, 0x4, 0x5, 0x4, 0x5, 0x2, 0x3, 0x0, 0x1);
+			const __m128i expand_mask1 = _mm_set_epi8(
+				-1, -1, -1, -1, -1, -1, -1, -1, 0x8, 0x9, 0xE, 0xF, 0xC, 0xD, 0xC, 0xD);
+
+			auto src_ptr = static_cast<const u16*>(src);
+			auto dst_ptr = static_cast<u16*>(dst);
+
+			const __m128i restart = _mm_set1_epi16(restart_index);
+			__m128i min = _mm_set1_epi16(-1);
+			__m128i max = _mm_set1_epi16(0);
+
+			u32 consumed = 0;
+			for (; consumed + 8 <= count; consumed += 8, src_ptr += 8, dst_ptr += 12)
+			{
+				const __m128i raw = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src_ptr));
+				const __m128i value = _mm_shuffle_epi8(raw, swap_mask);
+
+				if (check_restart && _mm_movemask_epi8(_mm_cmpeq_epi16(value, restart)))
+				{
+					break;
+				}
+
+				max = _mm_max_epu16(max, value);
+				min = _mm_min_epu16(min, value);
+
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(dst_ptr), _mm_shuffle_epi8(raw, expand_mask0));
+				_mm_storel_epi64(reinterpret_cast<__m128i*>(dst_ptr + 8), _mm_shuffle_epi8(raw, expand_mask1));
+			}
+
+			return std::make_tuple(sse41_hmin_epu16(min), sse41_hmax_epu16(max), consumed);
+		}
+
+		AVX2_FUNC
+		static
+		std::tuple<u32, u32, u32> expand_quads_u32_avx2(const void *src, void *dst, u32 count, bool check_restart, u32 restart_index)
+		{
+			const __m256i swap_mask = _mm256_broadcastsi128_si256(_mm_set_epi8(
+				0xC, 0xD, 0xE, 0xF, 0x8, 0x9, 0xA, 0xB, 0x4, 0x5, 0x6, 0x7, 0x0, 0x1, 0x2, 0x3));
+
+			// {0, 1, 2, 2, 3, 0, 4, 5} and {6, 6, 7, 4}
+			const __m256i expand_mask0 = _mm256_set_epi32(5, 4, 0, 3, 2, 2, 1, 0);
+			const __m256i expand_mask1 = _mm256_set_epi32(0, 0, 0, 0, 4, 7, 6, 6);
+
+			auto src_ptr = static_cast<const u32*>(src);
+			auto dst_ptr = static_cast<u32*>(dst);
+
+			const __m256i restart = _mm256_set1_epi32(restart_index);
+			__m256i min = _mm256_set1_epi32(~0u);
+			__m256i max = _mm256_set1_epi32(0);
+
+			u32 consumed = 0;
+			for (; consumed + 8 <= count; consumed += 8, src_ptr += 8, dst_ptr += 12)
+			{
+				const __m256i value = _mm256_shuffle_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(src_ptr)), swap_mask);
+
+				if (check_restart && _mm256_movemask_epi8(_mm256_cmpeq_epi32(value, restart)))
+				{
+					break;
+				}
+
+				max = _mm256_max_epu32(max, value);
+				min = _mm256_min_epu32(min, value);
+
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst_ptr), _mm256_permutevar8x32_epi32(value, expand_mask0));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(dst_ptr + 8), _mm256_castsi256_si128(_mm256_permutevar8x32_epi32(value, expand_mask1)));
+			}
+
+			const u32 min_index = sse41_hmin_epu32(_mm_min_epu32(_mm256_castsi256_si128(min), _mm256_extracti128_si256(min, 1)));
+			const u32 max_index = sse41_hmax_epu32(_mm_max_epu32(_mm256_castsi256_si128(max), _mm256_extracti128_si256(max, 1)));
+
+			return std::make_tuple(min_index, max_index, consumed);
+		}
+
+		SSE4_1_FUNC
+		static
+		std::tuple<u32, u32, u32> expand_quads_u32_sse4_1(const void *src, void *dst, u32 count, bool check_restart, u32 restart_index)
+		{
+			const __m128i swap_mask = _mm_set_epi8(
+				0xC, 0xD, 0xE, 0xF, 0x8, 0x9, 0xA, 0xB, 0x4, 0x5, 0x6, 0x7, 0x0, 0x1, 0x2, 0x3);
+
+			// Swap and expand {0, 1, 2, 3} to {0, 1, 2, 2} and {3, 0}
+			const __m128i expand_mask0 = _mm_set_epi8(
+				0x8, 0x9, 0xA, 0xB, 0x8, 0x9, 0xA, 0xB, 0x4, 0x5, 0x6, 0x7, 0x0, 0x1, 0x2, 0x3);
+			const __m128i expand_mask1 = _mm_set_epi8(
+				-1, -1, -1, -1, -1, -1, -1, -1, 0x0, 0x1, 0x2, 0x3, 0xC, 0xD, 0xE, 0xF);
+
+			auto src_ptr = static_cast<const u32*>(src);
+			auto dst_ptr = static_cast<u32*>(dst);
+
+			const __m128i restart = _mm_set1_epi32(restart_index);
+			__m128i min = _mm_set1_epi32(~0u);
+			__m128i max = _mm_set1_epi32(0);
+
+			u32 consumed = 0;
+			for (; consumed + 4 <= count; consumed += 4, src_ptr += 4, dst_ptr += 6)
+			{
+				const __m128i raw = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src_ptr));
+				const __m128i value = _mm_shuffle_epi8(raw, swap_mask);
+
+				if (check_restart && _mm_movemask_epi8(_mm_cmpeq_epi32(value, restart)))
+				{
+					break;
+				}
+
+				max = _mm_max_epu32(max, value);
+				min = _mm_min_epu32(min, value);
+
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(dst_ptr), _mm_shuffle_epi8(raw, expand_mask0));
+				_mm_storel_epi64(reinterpret_cast<__m128i*>(dst_ptr + 4), _mm_shuffle_epi8(raw, expand_mask1));
+			}
+
+			return std::make_tuple(sse41_hmin_epu32(min), sse41_hmax_epu32(max), consumed);
+		}
+
+		// Fan kernels emit {anchor, src[i - 1], src[i]} for each index, src[-1] must be readable.
+		// Blocks containing the invalid index are left to the scalar path since it is used as a marker there.
+		SSE4_1_FUNC
+		static
+		std::tuple<u16, u16, u32> expand_fan_u16_sse4_1(const void *src, void *dst, u32 count, u16 anchor, bool check_restart, u16 restart_index)
+		{
+			const __m128i swap_mask = _mm_set_epi8(
+				0xE, 0xF, 0xC, 0xD, 0xA, 0xB, 0x8, 0x9, 0x6, 0x7, 0x4, 0x5, 0x2, 0x3, 0x0, 0x1);
+
+			// From the previous indices: {a, p0, p1, a, p1, p2, a, p2}, {p3, a, p3, p4, a, p4, p5, a}
+			const __m128i expand_mask0 = _mm_set_epi8(
+				0x4, 0x5, -1, -1, 0x4, 0x5, 0x2, 0x3, -1, -1, 0x2, 0x3, 0x0, 0x1, -1, -1);
+			const __m128i expand_mask1 = _mm_set_epi8(
+				-1, -1, 0xA, 0xB, 0x8, 0x9, -1, -1, 0x8, 0x9, 0x6, 0x7, -1, -1, 0x6, 0x7);
+			// From the current indices: {c4, c5, a, c5, c6, a, c6, c7}
+			const __m128i expand_mask2 = _mm_set_epi8(
+				0xE, 0xF, 0xC, 0xD, -1, -1, 0xC, 0xD, 0xA, 0xB, -1, -1, 0xA, 0xB, 0x8, 0x9);
+
+			const __m128i anchor0 = _mm_set_epi16(0, anchor, 0, 0, anchor, 0, 0, anchor);
+			const __m128i anchor1 = _mm_set_epi16(anchor, 0, 0, anchor, 0, 0, anchor, 0);
+			const __m128i anchor2 = _mm_set_epi16(0, 0, anchor, 0, 0, anchor, 0, 0);
+
+			auto src_ptr = static_cast<const u16*>(src);
+			auto dst_ptr = static_cast<u16*>(dst);
+
+			const __m128i restart = _mm_set1_epi16(check_restart ? restart_index : 0xffff);
+			const __m128i invalid = _mm_set1_epi16(-1);
+			__m128i min = _mm_set1_epi16(-1);
+			__m128i max = _mm_set1_epi16(0);
+
+			u32 consumed = 0;
+			for (; consumed + 8 <= count; consumed += 8, src_ptr += 8, dst_ptr += 24)
+			{
+				const __m128i prev = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src_ptr - 1));
+				const __m128i raw = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src_ptr));
+				const __m128i value = _mm_shuffle_epi8(raw, swap_mask);
+
+				if (_mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi16(value, restart), _mm_cmpeq_epi16(value, invalid))))
+				{
+					break;
+				}
+
+				max = _mm_max_epu16(max, value);
+				min = _mm_min_epu16(min, value);
+
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(dst_ptr), _mm_or_si128(_mm_shuffle_epi8(prev, expand_mask0), anchor0));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(dst_ptr + 8), _mm_or_si128(_mm_shuffle_epi8(prev, expand_mask1), anchor1));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(dst_ptr + 16), _mm_or_si128(_mm_shuffle_epi8(raw, expand_mask2), anchor2));
+			}
+
+			return std::make_tuple(sse41_hmin_epu16(min), sse41_hmax_epu16(max), consumed);
+		}
+
+		SSE4_1_FUNC
+		static
+		std::tuple<u32, u32, u32> expand_fan_u32_sse4_1(const void *src, void *dst, u32 count, u32 anchor, bool check_restart, u32 restart_index)
+		{
+			const __m128i swap_mask = _mm_set_epi8(
+				0xC, 0xD, 0xE, 0xF, 0x8, 0x9, 0xA, 0xB, 0x4, 0x5, 0x6, 0x7, 0x0, 0x1, 0x2, 0x3);
+
+			// From the previous indices: {a, p0, p1, a}, {p1, p2, a, p2}
+			const __m128i expand_mask0 = _mm_set_epi8(
+				-1, -1, -1, -1, 0x4, 0x5, 0x6, 0x7, 0x0, 0x1, 0x2, 0x3, -1, -1, -1, -1);
+			const __m128i expand_mask1 = _mm_set_epi8(
+				0x8, 0x9, 0xA, 0xB, -1, -1, -1, -1, 0x8, 0x9, 0xA, 0xB, 0x4, 0x5, 0x6, 0x7);
+			// From the current indices: {c2, a, c2, c3}
+			const __m128i expand_mask2 = _mm_set_epi8(
+				0xC, 0xD, 0xE, 0xF, 0x8, 0x9, 0xA, 0xB, -1, -1, -1, -1, 0x8, 0x9, 0xA, 0xB);
+
+			const __m128i anchor0 = _mm_set_epi32(anchor, 0, 0, anchor);
+			const __m128i anchor1 = _mm_set_epi32(0, anchor, 0, 0);
+			const __m128i anchor2 = _mm_set_epi32(0, 0, anchor, 0);
+
+			auto src_ptr = static_cast<const u32*>(src);
+			auto dst_ptr = static_cast<u32*>(dst);
+
+			const __m128i restart = _mm_set1_epi32(check_restart ? restart_index : 0xffffffff);
+			const __m128i invalid = _mm_set1_epi32(-1);
+			__m128i min = _mm_set1_epi32(~0u);
+			__m128i max = _mm_set1_epi32(0);
+
+			u32 consumed = 0;
+			for (; consumed + 4 <= count; consumed += 4, src_ptr += 4, dst_ptr += 12)
+			{
+				const __m128i prev = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src_ptr - 1));
+				const __m128i raw = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src_ptr));
+				const __m128i value = _mm_shuffle_epi8(raw, swap_mask);
+
+				if (_mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi32(value, restart), _mm_cmpeq_epi32(value, invalid))))
+				{
+					break;
+				}
+
+				max = _mm_max_epu32(max, value);
+				min = _mm_min_epu32(min, value);
+
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(dst_ptr), _mm_or_si128(_mm_shuffle_epi8(prev, expand_mask0), anchor0));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(dst_ptr + 4), _mm_or_si128(_mm_shuffle_epi8(prev, expand_mask1), anchor1));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(dst_ptr + 8), _mm_or_si128(_mm_shuffle_epi8(raw, expand_mask2), anchor2));
+			}
+
+			return std::make_tuple(sse41_hmin_epu32(min), sse41_hmax_epu32(max), consumed);
+		}
+
+		template<typename T>
+		static
+		std::tuple<T, T, u32> expand_quads(gsl::span<to_be_t<const T>> src, gsl::span<T> dst, bool is_primitive_restart_enabled, u32 primitive_restart_index)
+		{
+			// Restart indices out of range of the index type never match
+			const bool check_restart = is_primitive_restart_enabled && primitive_restart_index <= index_limit<T>();
+			const T restart_index = static_cast<T>(primitive_restart_index);
+
+			if (s_use_avx2)
+			{
+				if constexpr (std::is_same<T, u16>::value)
+					return expand_quads_u16_avx2(src.data(), dst.data(), ::size32(src), check_restart, restart_index);
+				else
+					return expand_quads_u32_avx2(src.data(), dst.data(), ::size32(src), check_restart, restart_index);
+			}
+
+			if (s_use_sse4_1)
+			{
+				if constexpr (std::is_same<T, u16>::value)
+					return expand_quads_u16_sse4_1(src.data(), dst.data(), ::size32(src), check_restart, restart_index);
+				else
+					return expand_quads_u32_sse4_1(src.data(), dst.data(), ::size32(src), check_restart, restart_index);
+			}
+
+			return std::make_tuple(index_limit<T>(), T{0}, 0u);
+		}
+
+		template<typename T>
+		static
+		std::tuple<T, T, u32> expand_fan(gsl::span<to_be_t<const T>> src, gsl::span<T> dst, T anchor, bool is_primitive_restart_enabled, u32 primitive_restart_index)
+		{
+			const bool check_restart = is_primitive_restart_enabled && primitive_restart_index <= index_limit<T>();
+			const T restart_index = static_cast<T>(primitive_restart_index);
+
+			if (s_use_sse4_1)
+			{
+				if constexpr (std::is_same<T, u16>::value)
+					return expand_fan_u16_sse4_1(src.data(), dst.data(), ::size32(src), anchor, check_restart, restart_index);
+				else
+					return expand_fan_u32_sse4_1(src.data(), dst.data(), ::size32(src), anchor, check_restart, restart_index);
+			}
+
+			return std::make_tuple(index_limit<T>(), T{0}, 0u);
+		}
+	};
+
 	template<typename T>
 	std::tuple<T, T, u32> upload_untouched(gsl::span<to_be_t<const T>> src, gsl::span<T> dst, rsx::primitive_type draw_mode, bool is_primitive_restart_enabled, u32 primitive_restart_index)
 	{
@@ -1049,13 +1513,32 @@ namespace
 		ensure((dst.size() >= 3 * (src.size() - 2)));
 
 		u32 dst_idx = 0;
+		const u32 length = ::size32(src);
 
 		bool needs_anchor = true;
 		T anchor = invalid_index;
 		T last_index = invalid_index;
 
-		for (const T index : src)
+		for (u32 i = 0; i < length;)
 		{
+			if (!needs_anchor && last_index != invalid_index && length - i >= 32)
+			{
+				// last_index is src[i - 1] here, vectorize until the next restart
+				const auto [fan_min, fan_max, consumed] = expansion_impl::expand_fan<T>(src.subspan(i), dst.subspan(dst_idx), anchor, is_primitive_restart_enabled, primitive_restart_index);
+
+				if (consumed)
+				{
+					min_index = std::min(min_index, fan_min);
+					max_index = std::max(max_index, fan_max);
+					i += consumed;
+					dst_idx += consumed * 3;
+					last_index = src[i - 1];
+					continue;
+				}
+			}
+
+			const T index = src[i++];
+
 			if (needs_anchor)
 			{
 				if (is_primitive_restart_enabled && index == primitive_restart_index)
@@ -1099,11 +1582,29 @@ namespace
 		ensure((4 * dst.size_bytes() >= 6 * src.size_bytes()));
 
 		u32 dst_idx = 0;
+		const u32 length = ::size32(src);
 		u8 set_size = 0;
 		T tmp_indices[4];
 
-		for (const T index : src)
+		for (u32 i = 0; i < length;)
 		{
+			if (set_size == 0 && length - i >= 32)
+			{
+				// Vectorize whole quads until the next restart
+				const auto [quad_min, quad_max, consumed] = expansion_impl::expand_quads<T>(src.subspan(i), dst.subspan(dst_idx), is_primitive_restart_enabled, primitive_restart_index);
+
+				if (consumed)
+				{
+					min_index = std::min(min_index, quad_min);
+					max_index = std::max(max_index, quad_max);
+					i += consumed;
+					dst_idx += consumed / 4 * 6;
+					continue;
+				}
+			}
+
+			const T index = src[i++];
+
 			if (is_primitive_restart_enabled && index == primitive_restart_index)
 			{
 				//empty temp buffer
@@ -321,7 +321,11 @@ public:
 		const fragment_program_type& fragment_program = std::get<0>(fp_search);
 		const pipeline_key key = { vertex_program.id, fragment_program.id, pipelineProperties };
 
-		m_cache_miss_flag = true;
+		// Only lookups made by the renderer update the miss flag, cache preloading may run concurrently
+		if (allow_notification)
+		{
+			m_cache_miss_flag = true;
+		}
 
 		if (already_existing_vertex_program && already_existing_fragment_program)
 		{
@@ -331,7 +335,11 @@ public:
 			reader_lock lock(m_pipeline_mutex);
 			if (const auto I = m_storage.find(key); I != m_storage.end())
 			{
-				m_cache_miss_flag = (I->second == __null_pipeline_handle);
+				if (allow_notification)
+				{
+					m_cache_miss_flag = (I->second == __null_pipeline_handle);
+				}
+
 				return I->second.get();
 			}
 		}
@@ -342,7 +350,11 @@ public:
 			// Check if another submission completed in the mean time
 			if (const auto I = m_storage.find(key); I != m_storage.end())
 			{
-				m_cache_miss_flag = (I->second == __null_pipeline_handle);
+				if (allow_notification)
+				{
+					m_cache_miss_flag = (I->second == __null_pipeline_handle);
+				}
+
 				return I->second.get();
 			}
 
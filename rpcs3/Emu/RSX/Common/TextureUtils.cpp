@@ -5,6 +5,21 @@
 #include "../rsx_utils.h"
 
 #include "util/asm.hpp"
+#include "util/sysinfo.hpp"
+
+#include "emmintrin.h"
+#include "immintrin.h"
+
+#if defined(_MSC_VER)
+#define SSSE3_FUNC
+#define AVX2_FUNC
+#else
+#define SSSE3_FUNC __attribute__((__target__("ssse3")))
+#define AVX2_FUNC __attribute__((__target__("avx2")))
+#endif // _MSC_VER
+
+const bool s_use_ssse3 = utils::has_ssse3();
+const bool s_use_avx2 = utils::has_avx2();
 
 namespace
 {
@@ -22,15 +37,255 @@ namespace
 		return{ reinterpret_cast<T*>(unformated_span.data()), unformated_span.size_bytes() / sizeof(T) };
 	}
 
+	// Byteswap shuffle mask for 16-bit or 32-bit words
+	template <typename W>
+	__m128i get_swap_mask()
+	{
+		if constexpr (sizeof(W) == 2)
+			return _mm_set_epi8(0xE, 0xF, 0xC, 0xD, 0xA, 0xB, 0x8, 0x9, 0x6, 0x7, 0x4, 0x5, 0x2, 0x3, 0x0, 0x1);
+		else
+			return _mm_set_epi8(0xC, 0xD, 0xE, 0xF, 0x8, 0x9, 0xA, 0xB, 0x4, 0x5, 0x6, 0x7, 0x0, 0x1, 0x2, 0x3);
+	}
+
+	template <typename W>
+	SSSE3_FUNC void copy_swapped_ssse3(W* dst, const be_t<W>* src, u32 count)
+	{
+		const __m128i mask = get_swap_mask<W>();
+		constexpr u32 step = 16 / sizeof(W);
+
+		u32 i = 0;
+		for (; i + step <= count; i += step)
+		{
+			const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_shuffle_epi8(v, mask));
+		}
+
+		for (; i < count; ++i)
+		{
+			dst[i] = src[i];
+		}
+	}
+
+	template <typename W>
+	AVX2_FUNC void copy_swapped_avx2(W* dst, const be_t<W>* src, u32 count)
+	{
+		const __m256i mask = _mm256_broadcastsi128_si256(get_swap_mask<W>());
+		constexpr u32 step = 32 / sizeof(W);
+
+		u32 i = 0;
+		for (; i + step <= count; i += step)
+		{
+			const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_shuffle_epi8(v, mask));
+		}
+
+		for (; i < count; ++i)
+		{
+			dst[i] = src[i];
+		}
+	}
+
 	// TODO: Make this function part of GSL
 	// Note: Doesn't handle overlapping range detection.
 	template<typename T1, typename T2>
-	constexpr void copy(gsl::span<T1> dst, gsl::span<T2> src)
+	void copy(gsl::span<T1> dst, gsl::span<T2> src)
 	{
 		static_assert(std::is_convertible<T1, T2>::value, "Cannot convert source and destination span type.");
+
+		if constexpr ((sizeof(T1) == 2 || sizeof(T1) == 4) && std::is_same_v<std::remove_const_t<T2>, be_t<T1>>)
+		{
+			// Byteswapping copy (16/32-bit texel formats)
+			if (s_use_avx2)
+			{
+				copy_swapped_avx2<T1>(dst.data(), src.data(), ::size32(src));
+				return;
+			}
+
+			if (s_use_ssse3)
+			{
+				copy_swapped_ssse3<T1>(dst.data(), src.data(), ::size32(src));
+				return;
+			}
+		}
+
 		std::copy(src.begin(), src.end(), dst.begin());
 	}
 
+	// Texel offsets of every 2D tile of a swizzled texture, following the same traversal as rsx::convert_linear_swizzle.
+	// A tile is tile_w x 2 texels; with tile_w <= 4 and even dimensions each tile is stored as consecutive 2x2 quads.
+	struct swizzled_tile_offsets
+	{
+		std::vector<u32> x; // Offset of each column of tiles within a row of tiles
+		std::vector<u32> y; // Offset of each row of tiles
+
+		swizzled_tile_offsets(u16 width, u16 height, u32 tile_w)
+		{
+			const u32 log2width = rsx::ceil_log2(width);
+			const u32 log2height = rsx::ceil_log2(height);
+
+			u32 limit_mask = std::min(log2width, log2height);
+			limit_mask = 1 << (limit_mask << 1);
+
+			const u32 x_mask = 0x55555555 | ~(limit_mask - 1);
+			const u32 y_mask = 0xAAAAAAAA & (limit_mask - 1);
+
+			x.reserve(width / tile_w);
+			y.reserve(height / 2);
+
+			for (u32 i = 0, offs_x = 0; i < width; ++i)
+			{
+				if (i % tile_w == 0)
+				{
+					x.push_back(offs_x);
+				}
+
+				offs_x = (offs_x - x_mask) & x_mask;
+			}
+
+			for (u32 i = 0, offs_y = 0, offs_x0 = 0; i < height; ++i)
+			{
+				if (i % 2 == 0)
+				{
+					y.push_back(offs_y + offs_x0);
+				}
+
+				offs_y = (offs_y - y_mask) & y_mask;
+
+				if (offs_y == 0)
+				{
+					offs_x0 += limit_mask;
+				}
+			}
+		}
+	};
+
+	// Deswizzle with byteswap. S is the texel size in bytes, W is the word type being swapped.
+	// 2 and 4 byte texels are copied in 4x2 tiles {00, 10, 01, 11, 20, 30, 21, 31}, larger texels in 2x2 quads {00, 10, 01, 11}
+	template <typename W, u32 S>
+	SSSE3_FUNC void deswizzle_swapped_ssse3(u8* dst, const u8* src, const swizzled_tile_offsets& offsets, u32 dst_pitch)
+	{
+		const __m128i mask = get_swap_mask<W>();
+		const __m128i mask_4x2 = _mm_set_epi8(14, 15, 12, 13, 6, 7, 4, 5, 10, 11, 8, 9, 2, 3, 0, 1);
+
+		for (const u32 offs_y : offsets.y)
+		{
+			u8* dst0 = dst;
+			u8* dst1 = dst + dst_pitch;
+
+			for (const u32 offs_x : offsets.x)
+			{
+				const auto tile = reinterpret_cast<const __m128i*>(src + (offs_y + offs_x) * S);
+
+				if constexpr (S == 2)
+				{
+					const __m128i v = _mm_shuffle_epi8(_mm_loadu_si128(tile), mask_4x2);
+					_mm_storel_epi64(reinterpret_cast<__m128i*>(dst0), v);
+					_mm_storel_epi64(reinterpret_cast<__m128i*>(dst1), _mm_unpackhi_epi64(v, v));
+				}
+				else if constexpr (S == 4)
+				{
+					const __m128i a = _mm_loadu_si128(tile);
+					const __m128i b = _mm_loadu_si128(tile + 1);
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(dst0), _mm_shuffle_epi8(_mm_unpacklo_epi64(a, b), mask));
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(dst1), _mm_shuffle_epi8(_mm_unpackhi_epi64(a, b), mask));
+				}
+				else
+				{
+					constexpr u32 n = S / 8;
+
+					for (u32 i = 0; i < n; ++i)
+					{
+						_mm_storeu_si128(reinterpret_cast<__m128i*>(dst0) + i, _mm_shuffle_epi8(_mm_loadu_si128(tile + i), mask));
+						_mm_storeu_si128(reinterpret_cast<__m128i*>(dst1) + i, _mm_shuffle_epi8(_mm_loadu_si128(tile + n + i), mask));
+					}
+				}
+
+				dst0 += (S <= 4 ? 4 : 2) * S;
+				dst1 += (S <= 4 ? 4 : 2) * S;
+			}
+
+			dst += dst_pitch * 2;
+		}
+	}
+
+	template <typename W, u32 S>
+	AVX2_FUNC void deswizzle_swapped_avx2(u8* dst, const u8* src, const swizzled_tile_offsets& offsets, u32 dst_pitch)
+	{
+		const __m256i mask = _mm256_broadcastsi128_si256(get_swap_mask<W>());
+
+		for (const u32 offs_y : offsets.y)
+		{
+			u8* dst0 = dst;
+			u8* dst1 = dst + dst_pitch;
+
+			for (const u32 offs_x : offsets.x)
+			{
+				const auto tile = reinterpret_cast<const __m256i*>(src + (offs_y + offs_x) * S);
+
+				if constexpr (S == 4 || S == 8)
+				{
+					__m256i v = _mm256_loadu_si256(tile);
+
+					if constexpr (S == 4)
+					{
+						// Gather the row halves: {00, 10, 20, 30 | 01, 11, 21, 31}
+						v = _mm256_permute4x64_epi64(v, 0xD8);
+					}
+
+					v = _mm256_shuffle_epi8(v, mask);
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(dst0), _mm256_castsi256_si128(v));
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(dst1), _mm256_extracti128_si256(v, 1));
+				}
+				else
+				{
+					_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst0), _mm256_shuffle_epi8(_mm256_loadu_si256(tile), mask));
+					_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst1), _mm256_shuffle_epi8(_mm256_loadu_si256(tile + 1), mask));
+				}
+
+				dst0 += (S <= 4 ? 4 : 2) * S;
+				dst1 += (S <= 4 ? 4 : 2) * S;
+			}
+
+			dst += dst_pitch * 2;
+		}
+	}
+
+	// Deswizzle a 2D texture and convert it to native endianness in one pass. Returns false if the layout is unsupported.
+	template <typename W>
+	bool deswizzle_swapped(W* dst, const be_t<W>* src, u16 words_per_block, u16 width, u16 height, u32 dst_pitch_in_block)
+	{
+		const u32 texel_size = words_per_block * sizeof(W);
+		const u32 tile_w = texel_size <= 4 ? 4 : 2;
+
+		if (!s_use_ssse3 || width % tile_w || height % 2 || (texel_size & (texel_size - 1)) || texel_size < sizeof(W) || texel_size > 16)
+		{
+			return false;
+		}
+
+		const swizzled_tile_offsets offsets(width, height, tile_w);
+		const auto out = reinterpret_cast<u8*>(dst);
+		const auto in = reinterpret_cast<const u8*>(src);
+		const u32 dst_pitch = dst_pitch_in_block * texel_size;
+
+		switch (texel_size)
+		{
+		case 2:
+			deswizzle_swapped_ssse3<W, 2>(out, in, offsets, dst_pitch);
+			break;
+		case 4:
+			s_use_avx2 ? deswizzle_swapped_avx2<W, 4>(out, in, offsets, dst_pitch) : deswizzle_swapped_ssse3<W, 4>(out, in, offsets, dst_pitch);
+			break;
+		case 8:
+			s_use_avx2 ? deswizzle_swapped_avx2<W, 8>(out, in, offsets, dst_pitch) : deswizzle_swapped_ssse3<W, 8>(out, in, offsets, dst_pitch);
+			break;
+		case 16:
+			s_use_avx2 ? deswizzle_swapped_avx2<W, 16>(out, in, offsets, dst_pitch) : deswizzle_swapped_ssse3<W, 16>(out, in, offsets, dst_pitch);
+			break;
+		}
+
+		return true;
+	}
+
 	u16 convert_rgb655_to_rgb565(const u16 bits)
 	{
 		// g6 = g5
@@ -88,6 +343,14 @@ struct copy_unmodified_block_swizzled
 	template<typename T, typename U>
 	static void copy_mipmap_level(gsl::span<T> dst, gsl::span<const U> src, u16 words_per_block, u16 width_in_block, u16 row_count, u16 depth, u8 border, u32 dst_pitch_in_block)
 	{
+		if constexpr (!std::is_same_v<T, U> && (sizeof(T) == 2 || sizeof(T) == 4))
+		{
+			if (depth == 1 && !border && deswizzle_swapped<T>(dst.data(), src.data(), words_per_block, width_in_block, row_count, dst_pitch_in_block))
+			{
+				return;
+			}
+		}
+
 		if (std::is_same<T, U>::value && dst_pitch_in_block == width_in_block && words_per_block == 1 && !border)
 		{
 			rsx::convert_linear_swizzle_3d<T>(src.data(), dst.data(), width_in_block, row_count, depth);
@@ -0,0 +1,357 @@
+#include "stdafx.h"
+#include "decompiled_program_cache.h"
+#include "ProgramStateCache.h"
+#include "Emu/System.h"
+#include "Emu/system_config.h"
+
+namespace
+{
+	struct file_header
+	{
+		u64 magic;
+		u32 version;
+		u32 reserved;
+	};
+
+	// Followed by the key and the serialized program
+	struct record_header
+	{
+		u32 size; // Total size of the record including this header
+		u32 key_size;
+	};
+
+	constexpr u64 c_file_magic = "RSXDECMP"_u64;
+	constexpr u32 c_file_version = 1;
+
+	template <typename T>
+	void append(std::vector<u8>& out, const T& value)
+	{
+		const usz pos = out.size();
+		out.resize(pos + sizeof(T));
+		std::memcpy(out.data() + pos, &value, sizeof(T));
+	}
+
+	void append(std::vector<u8>& out, const void* data, usz size)
+	{
+		const usz pos = out.size();
+		out.resize(pos + size);
+		std::memcpy(out.data() + pos, data, size);
+	}
+
+	void append(std::vector<u8>& out, const std::string& str)
+	{
+		append(out, ::size32(str));
+		append(out, str.data(), str.size());
+	}
+
+	struct record_reader
+	{
+		const u8* data;
+		usz size;
+		usz pos = 0;
+
+		template <typename T>
+		bool read(T& value)
+		{
+			if (size - pos < sizeof(T))
+			{
+				return false;
+			}
+
+			std::memcpy(&value, data + pos, sizeof(T));
+			pos += sizeof(T);
+			return true;
+		}
+
+		bool read(std::string& str)
+		{
+			u32 length;
+
+			if (!read(length) || size - pos < length)
+			{
+				return false;
+			}
+
+			str.assign(reinterpret_cast<const char*>(data + pos), length);
+			pos += length;
+			return true;
+		}
+	};
+
+	u64 hash_key(const std::vector<u8>& key)
+	{
+		// 64-bit FNV-1a
+		u64 hash = rpcs3::fnv_seed;
+
+		for (u8 byte : key)
+		{
+			hash ^= byte;
+			hash *= rpcs3::fnv_prime;
+		}
+
+		return hash;
+	}
+
+	bool deserialize(record_reader& reader, rsx::decompiled_program& result)
+	{
+		u32 count;
+
+		if (!reader.read(result.source) || !reader.read(count) || count > reader.size)
+		{
+			return false;
+		}
+
+		result.inputs.resize(count);
+
+		for (auto& input : result.inputs)
+		{
+			if (!reader.read(input.domain) || !reader.read(input.type) || !reader.read(input.location) || !reader.read(input.name))
+			{
+				return false;
+			}
+		}
+
+		if (!reader.read(count) || count > reader.size)
+		{
+			return false;
+		}
+
+		result.constant_offsets.resize(count);
+
+		for (auto& offset : result.constant_offsets)
+		{
+			if (!reader.read(offset))
+			{
+				return false;
+			}
+		}
+
+		return reader.read(result.output_color_masks) && reader.pos == reader.size;
+	}
+}
+
+namespace rsx
+{
+	decompiled_program_cache::decompiled_program_cache(std::string_view backend, std::string_view version)
+	{
+		if (g_cfg.video.disable_on_disk_shader_cache)
+		{
+			return;
+		}
+
+		const std::string directory_path = fmt::format("%sshaders_cache/decompiled/%s/%s/", Emu.PPUCache(), backend, version);
+
+		if (!fs::create_path(directory_path))
+		{
+			rsx_log.error("Failed to create decompiled shader cache directory %s (%s)", directory_path, fs::g_tls_error);
+			return;
+		}
+
+		open(m_vertex_programs, directory_path + "vertex.bin");
+		open(m_fragment_programs, directory_path + "fragment.bin");
+	}
+
+	decompiled_program_cache::cache_file& decompiled_program_cache::get_file(::glsl::program_domain domain)
+	{
+		return domain == ::glsl::glsl_vertex_program ? m_vertex_programs : m_fragment_programs;
+	}
+
+	void decompiled_program_cache::open(cache_file& cache, const std::string& path)
+	{
+		if (!cache.file.open(path, fs::read + fs::write + fs::create))
+		{
+			rsx_log.error("Failed to open decompiled shader cache %s (%s)", path, fs::g_tls_error);
+			return;
+		}
+
+		file_header header{};
+
+		if (cache.file.size() < sizeof(file_header) || !cache.file.read(header) || header.magic != c_file_magic || header.version != c_file_version)
+		{
+			if (cache.file.size())
+			{
+				rsx_log.warning("Discarding incompatible decompiled shader cache %s", path);
+			}
+
+			cache.file.trunc(0);
+			cache.file.seek(0);
+			cache.file.write(file_header{c_file_magic, c_file_version, 0});
+			return;
+		}
+
+		// Only index the keys, programs are read back on demand
+		const std::vector<u8> buffer = cache.file.to_vector<u8>();
+		usz pos = sizeof(file_header);
+
+		while (buffer.size() - pos >= sizeof(record_header))
+		{
+			record_header record;
+			std::memcpy(&record, buffer.data() + pos, sizeof(record_header));
+
+			if (record.size < sizeof(record_header) + u64{record.key_size} || record.size > buffer.size() - pos)
+			{
+				break;
+			}
+
+			const u8* key = buffer.data() + pos + sizeof(record_header);
+			cache.records.emplace(hash_key({key, key + record.key_size}), record_location{pos, record.size});
+			pos += record.size;
+		}
+
+		if (pos != buffer.size())
+		{
+			rsx_log.warning("Decompiled shader cache %s is truncated at offset 0x%x", path, pos);
+			cache.file.trunc(pos);
+		}
+
+		rsx_log.notice("Decompiled shader cache %s: %u programs", path, cache.records.size());
+	}
+
+	std::vector<u8> decompiled_program_cache::get_key(const RSXVertexProgram& prog, const void* env, usz env_size)
+	{
+		// Covers the same state as vertex_program_compare
+		std::vector<u8> key;
+		append(key, static_cast<u32>(env_size));
+		append(key, env, env_size);
+		append(key, prog.output_mask);
+		append(key, prog.texture_dimensions);
+		append(key, ::size32(prog.data));
+		append(key, ::size32(prog.jump_table));
+
+		for (u32 address : prog.jump_table)
+		{
+			append(key, address);
+		}
+
+		for (u32 i = 0; i < prog.data.size() / 4; i++)
+		{
+			if (prog.instruction_mask[i])
+			{
+				append(key, i);
+				append(key, prog.data.data() + i * 4, 16);
+			}
+		}
+
+		return key;
+	}
+
+	std::vector<u8> decompiled_program_cache::get_key(const RSXFragmentProgram& prog, const void* env, usz env_size)
+	{
+		// Covers the same state as fragment_program_compare, embedded constants are ignored
+		std::vector<u8> key;
+		append(key, static_cast<u32>(env_size));
+		append(key, env, env_size);
+		append(key, prog.ctrl);
+		append(key, prog.texture_dimensions);
+		append(key, prog.unnormalized_coords);
+		append(key, prog.two_sided_lighting);
+		append(key, prog.shadow_textures);
+		append(key, prog.redirected_textures);
+
+		const auto ucode = static_cast<const u8*>(prog.get_data());
+
+		for (u32 offset = 0; offset + 16 <= prog.ucode_length;)
+		{
+			u32 inst[4];
+			std::memcpy(inst, ucode + offset, 16);
+			append(key, inst);
+			offset += 16;
+
+			if (program_hash_util::fragment_program_utils::is_constant(inst[1]) ||
+				program_hash_util::fragment_program_utils::is_constant(inst[2]) ||
+				program_hash_util::fragment_program_utils::is_constant(inst[3]))
+			{
+				offset += 16;
+			}
+
+			if ((inst[0] >> 8) & 0x1)
+			{
+				break;
+			}
+		}
+
+		return key;
+	}
+
+	bool decompiled_program_cache::find(::glsl::program_domain domain, const std::vector<u8>& key, decompiled_program& result)
+	{
+		auto& cache = get_file(domain);
+
+		std::lock_guard lock(cache.mutex);
+
+		if (!cache.file)
+		{
+			return false;
+		}
+
+		const auto [first, last] = cache.records.equal_range(hash_key(key));
+
+		for (auto it = first; it != last; ++it)
+		{
+			std::vector<u8> buffer(it->second.size);
+			cache.file.seek(it->second.offset);
+
+			if (cache.file.read(buffer.data(), buffer.size()) != buffer.size())
+			{
+				continue;
+			}
+
+			record_header record;
+			std::memcpy(&record, buffer.data(), sizeof(record_header));
+
+			if (record.key_size != key.size() || std::memcmp(buffer.data() + sizeof(record_header), key.data(), key.size()) != 0)
+			{
+				continue;
+			}
+
+			record_reader reader{buffer.data() + sizeof(record_header) + key.size(), buffer.size() - sizeof(record_header) - key.size()};
+
+			if (deserialize(reader, result))
+			{
+				return true;
+			}
+
+			rsx_log.error("Corrupted entry in decompiled shader cache at offset 0x%x", it->second.offset);
+		}
+
+		return false;
+	}
+
+	void decompiled_program_cache::store(::glsl::program_domain domain, const std::vector<u8>& key, const decompiled_program& prog)
+	{
+		auto& cache = get_file(domain);
+
+		std::vector<u8> buffer;
+		append(buffer, record_header{});
+		append(buffer, key.data(), key.size());
+		append(buffer, prog.source);
+		append(buffer, ::size32(prog.inputs));
+
+		for (const auto& input : prog.inputs)
+		{
+			append(buffer, input.domain);
+			append(buffer, input.type);
+			append(buffer, input.location);
+			append(buffer, input.name);
+		}
+
+		append(buffer, ::size32(prog.constant_offsets));
+		append(buffer, prog.constant_offsets.data(), prog.constant_offsets.size() * sizeof(u32));
+		append(buffer, prog.output_color_masks);
+
+		const record_header header{::size32(buffer), ::size32(key)};
+		std::memcpy(buffer.data(), &header, sizeof(record_header));
+
+		std::lock_guard lock(cache.mutex);
+
+		if (!cache.file)
+		{
+			return;
+		}
+
+		// Duplicates from concurrent misses are harmless, lookups return the first match
+		const u64 offset = cache.file.seek(0, fs::seek_end);
+		cache.file.write(buffer.data(), buffer.size());
+		cache.records.emplace(hash_key(key), record_location{offset, header.size});
+	}
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "Emu/RSX/RSXFragmentProgram.h"
+#include "Emu/RSX/RSXVertexProgram.h"
+#include "Utilities/File.h"
+#include "Utilities/mutex.h"
+#include "GLSLTypes.h"
+
+#include <array>
+#include <unordered_map>
+
+namespace rsx
+{
+	// Backend independent result of a decompiler run
+	struct decompiled_program
+	{
+		struct program_input
+		{
+			u32 domain;
+			u32 type;
+			u32 location;
+			std::string name;
+		};
+
+		std::string source;
+		std::vector<program_input> inputs;        // Resources declared by the decompiler
+		std::vector<u32> constant_offsets;        // Fragment constant registers referenced by the program
+		std::array<u32, 4> output_color_masks{};
+	};
+
+	// On-disk cache of decompiled programs, keyed by program contents and the decompiler environment
+	class decompiled_program_cache
+	{
+		struct record_location
+		{
+			u64 offset;
+			u32 size;
+		};
+
+		struct cache_file
+		{
+			fs::file file;
+			std::unordered_multimap<u64, record_location> records;
+			shared_mutex mutex;
+		};
+
+		cache_file m_vertex_programs;
+		cache_file m_fragment_programs;
+
+		cache_file& get_file(::glsl::program_domain domain);
+
+		void open(cache_file& cache, const std::string& path);
+
+	public:
+		// The version string must be changed whenever the backend decompiler output changes
+		decompiled_program_cache(std::string_view backend, std::string_view version);
+
+		// Build a lookup key, env must contain all backend state which affects the generated source
+		static std::vector<u8> get_key(const RSXVertexProgram& prog, const void* env, usz env_size);
+		static std::vector<u8> get_key(const RSXFragmentProgram& prog, const void* env, usz env_size);
+
+		bool find(::glsl::program_domain domain, const std::vector<u8>& key, decompiled_program& result);
+		void store(::glsl::program_domain domain, const std::vector<u8>& key, const decompiled_program& prog);
+	};
+}
@@ -6,6 +6,8 @@
 #include "GLCommonDecompiler.h"
 #include "../GCM.h"
 #include "../Common/GLSLCommon.h"
+#include "../Common/decompiled_program_cache.h"
+#include "Emu/IdManager.h"
 
 std::string GLFragmentDecompilerThread::getFloatTypeName(usz elementCount)
 {
@@ -358,6 +360,31 @@ void GLFragmentProgram::Decompile(const RSXFragmentProgram& prog)
 		decompiler.device_props.has_native_half_support = driver_caps.NV_gpu_shader5_supported || driver_caps.AMD_gpu_shader_half_float_supported;
 	}
 
+	// Everything besides the program itself which affects the generated source
+	const struct
+	{
+		bool has_native_half_support;
+		bool emulate_depth_compare;
+		bool low_precision_tests;
+	}
+	env
+	{
+		decompiler.device_props.has_native_half_support,
+		decompiler.device_props.emulate_depth_compare,
+		gl::get_driver_caps().vendor_NVIDIA
+	};
+
+	const auto cache = g_fxo->try_get<rsx::decompiled_program_cache>();
+	const std::vector<u8> key = cache ? cache->get_key(prog, &env, sizeof(env)) : std::vector<u8>{};
+
+	if (rsx::decompiled_program cached; cache && cache->find(::glsl::glsl_fragment_program, key, cached))
+	{
+		FragmentConstantOffsetCache.assign(cached.constant_offsets.begin(), cached.constant_offsets.end());
+		shader.create(::glsl::program_domain::glsl_fragment_program, cached.source);
+		id = shader.id();
+		return;
+	}
+
 	decompiler.Task();
 
 	for (const ParamType& PT : decompiler.m_parr.params[PF_PARAM_UNIFORM])
@@ -377,6 +404,14 @@ void GLFragmentProgram::Decompile(const RSXFragmentProgram& prog)
 
 	shader.create(::glsl::program_domain::glsl_fragment_program, source);
 	id = shader.id();
+
+	if (cache)
+	{
+		rsx::decompiled_program result;
+		result.source = std::move(source);
+		result.constant_offsets.assign(FragmentConstantOffsetCache.begin(), FragmentConstantOffsetCache.end());
+		cache->store(::glsl::glsl_fragment_program, key, result);
+	}
 }
 
 void GLFragmentProgram::Delete()
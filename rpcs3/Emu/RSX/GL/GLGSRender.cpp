@@ -8,6 +8,7 @@
 #include "Emu/RSX/rsx_methods.h"
 
 #include "../Common/program_state_cache2.hpp"
+#include "../Common/decompiled_program_cache.h"
 
 #define DUMP_VERTEX_DATA 0
 
@@ -19,6 +20,7 @@ u64 GLGSRender::get_cycles()
 GLGSRender::GLGSRender() : GSRender()
 {
 	m_shaders_cache = std::make_unique<gl::shader_cache>(m_prog_buffer, "opengl", "v1.91");
+	g_fxo->init<rsx::decompiled_program_cache>("opengl", "v1");
 
 	if (g_cfg.video.disable_vertex_cache || g_cfg.video.multithreaded_rsx)
 		m_vertex_cache = std::make_unique<gl::null_vertex_cache>();
@@ -329,7 +331,7 @@ void GLGSRender::on_init_thread()
 		[this](void* const& props, const RSXVertexProgram& vp, const RSXFragmentProgram& fp)
 		{
 			// Program was linked or queued for linking
-			m_shaders_cache->store(props, vp, fp);
+			m_shaders_cache->store(props, vp, fp, performance_counters.presented_frames);
 		}
 	);
 
@@ -5,6 +5,8 @@
 
 #include "GLCommonDecompiler.h"
 #include "../Common/GLSLCommon.h"
+#include "../Common/decompiled_program_cache.h"
+#include "Emu/IdManager.h"
 
 #include <algorithm>
 
@@ -268,12 +270,43 @@ GLVertexProgram::~GLVertexProgram()
 
 void GLVertexProgram::Decompile(const RSXVertexProgram& prog)
 {
+	const auto& dev_caps = gl::get_driver_caps();
+
+	// Everything besides the program itself which affects the generated source
+	const struct
+	{
+		bool emulate_depth_clip_only;
+		bool vendor_INTEL;
+	}
+	env
+	{
+		dev_caps.NV_depth_buffer_float_supported,
+		dev_caps.vendor_INTEL
+	};
+
+	const auto cache = g_fxo->try_get<rsx::decompiled_program_cache>();
+	const std::vector<u8> key = cache ? cache->get_key(prog, &env, sizeof(env)) : std::vector<u8>{};
+
+	if (rsx::decompiled_program cached; cache && cache->find(::glsl::glsl_vertex_program, key, cached))
+	{
+		shader.create(::glsl::program_domain::glsl_vertex_program, cached.source);
+		id = shader.id();
+		return;
+	}
+
 	std::string source;
 	GLVertexDecompilerThread decompiler(prog, source, parr);
 	decompiler.Task();
 
 	shader.create(::glsl::program_domain::glsl_vertex_program, source);
 	id = shader.id();
+
+	if (cache)
+	{
+		rsx::decompiled_program result;
+		result.source = std::move(source);
+		cache->store(::glsl::glsl_vertex_program, key, result);
+	}
 }
 
 void GLVertexProgram::Delete()
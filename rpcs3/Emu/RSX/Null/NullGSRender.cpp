@@ -1,5 +1,6 @@
 #include "stdafx.h"
 #include "NullGSRender.h"
+#include "Emu/Cell/timers.hpp"
 
 u64 NullGSRender::get_cycles()
 {
@@ -10,8 +11,71 @@ NullGSRender::NullGSRender() : GSRender()
 {
 }
 
+void NullGSRender::upload_vertex_data()
+{
+	constexpr u32 scratch_size = 64 * 0x100000;
+
+	auto& draw_clause = rsx::method_registers.current_draw_clause;
+
+	if (draw_clause.command != rsx::draw_command::array)
+	{
+		return;
+	}
+
+	draw_clause.begin();
+	analyse_inputs_interleaved(m_vertex_layout);
+
+	if (!m_vertex_layout.validate())
+	{
+		return;
+	}
+
+	const u32 vertex_base = draw_clause.min_index();
+	const u32 vertex_count = draw_clause.get_elements_count();
+	const auto required = calculate_memory_requirements(m_vertex_layout, vertex_base, vertex_count);
+	const u32 size = required.first + required.second;
+
+	if (!size || size > scratch_size)
+	{
+		return;
+	}
+
+	if (!m_dma_scratch)
+	{
+		m_dma_scratch = std::make_unique<u8[]>(scratch_size);
+		m_dma_stat_time = get_system_time();
+	}
+
+	if (m_dma_scratch_offset + size > scratch_size)
+	{
+		// Wrap around, wait for pending transfers to the beginning of the buffer
+		g_fxo->get<rsx::dma_manager>().sync();
+		m_dma_scratch_offset = 0;
+	}
+
+	u8* const persistent = m_dma_scratch.get() + m_dma_scratch_offset;
+	write_vertex_data_to_memory(m_vertex_layout, vertex_base, vertex_count, required.first ? persistent : nullptr, required.second ? persistent + required.first : nullptr);
+	m_dma_scratch_offset += size;
+
+	if (const u64 now = get_system_time(); now - m_dma_stat_time >= 1'000'000)
+	{
+		const auto stats = rsx::dma_manager::get_stats();
+		const f64 elapsed = (now - m_dma_stat_time) / 1'000'000.;
+
+		rsx_log.notice("DMA benchmark: %.0f packets/s, %.3f MB/s", (stats.first - m_dma_stat_last.first) / elapsed, (stats.second - m_dma_stat_last.second) / elapsed / 0x100000);
+
+		m_dma_stat_time = now;
+		m_dma_stat_last = stats;
+	}
+}
+
 void NullGSRender::end()
 {
+	if (g_cfg.video.null_dma_benchmark && g_cfg.video.multithreaded_rsx)
+	{
+		upload_vertex_data();
+	}
+
 	execute_nop_draw();
 	rsx::thread::end();
 }
@@ -8,5 +8,14 @@ public:
 	NullGSRender();
 
 private:
+	// DMA benchmark: vertex data is uploaded to host memory through the offloader
+	rsx::vertex_input_layout m_vertex_layout = {};
+	std::unique_ptr<u8[]> m_dma_scratch;
+	u32 m_dma_scratch_offset = 0;
+	u64 m_dma_stat_time = 0;
+	std::pair<u64, u64> m_dma_stat_last = {};
+
+	void upload_vertex_data();
+
 	void end() override;
 };
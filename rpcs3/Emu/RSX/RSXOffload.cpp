@@ -12,13 +12,38 @@ namespace rsx
 {
 	struct dma_manager::offload_thread
 	{
-		lf_queue<transport_packet> m_work_queue;
+		// Preallocated packet ring (producers are serialized, single consumer)
+		static constexpr u32 s_packet_count = 8192;
+
+		// Preallocated storage for vector_copy payloads
+		static constexpr u32 s_arena_size = 16 * 0x100000;
+
+		std::unique_ptr<transport_packet[]> m_packets;
+		std::unique_ptr<u8[]> m_arena;
+		shared_mutex m_put_mutex;
+		u64 m_arena_put = 0;
+		u64 m_arena_pos = 0;
+		atomic_t<u64> m_arena_get = 0;
 		atomic_t<u64> m_enqueued_count = 0;
 		atomic_t<u64> m_processed_count = 0;
+		transport_packet m_current_packet{};
 		transport_packet* m_current_job = nullptr;
 
+		// Statistics
+		atomic_t<u64> m_stat_packets = 0;
+		atomic_t<u64> m_stat_bytes = 0;
+
 		std::thread::id m_thread_id;
 
+		offload_thread()
+		{
+			if (g_cfg.video.multithreaded_rsx)
+			{
+				m_packets = std::make_unique<transport_packet[]>(s_packet_count);
+				m_arena = std::make_unique<u8[]>(s_arena_size);
+			}
+		}
+
 		void operator ()()
 		{
 			if (!g_cfg.video.multithreaded_rsx)
@@ -36,20 +61,38 @@ namespace rsx
 
 			while (thread_ctrl::state() != thread_state::aborting)
 			{
-				for (auto&& job : m_work_queue.pop_all())
+				for (u64 pos = m_processed_count, end = m_enqueued_count; pos < end;)
 				{
-					m_current_job = &job;
+					m_current_packet = m_packets[pos % s_packet_count];
+					m_current_job = &m_current_packet;
+
+					auto& job = m_current_packet;
+					u64 count = 1;
 
 					switch (job.type)
 					{
 					case raw_copy:
 					{
+						// Merge adjacent copies
+						for (; pos + count < end && job.length < 0x10000000; count++)
+						{
+							const auto& next = m_packets[(pos + count) % s_packet_count];
+
+							if (next.type != raw_copy || next.dst != static_cast<u8*>(job.dst) + job.length || next.src != static_cast<u8*>(job.src) + job.length)
+							{
+								break;
+							}
+
+							job.length += next.length;
+						}
+
 						std::memcpy(job.dst, job.src, job.length);
 						break;
 					}
 					case vector_copy:
 					{
-						std::memcpy(job.dst, job.opt_storage.data(), job.length);
+						std::memcpy(job.dst, job.src, job.length);
+						m_arena_get.release(job.arena_end);
 						break;
 					}
 					case index_emulate:
@@ -65,14 +108,20 @@ namespace rsx
 					default: fmt::throw_exception("Unreachable");
 					}
 
-					m_processed_count.release(m_processed_count + 1);
+					m_stat_packets.release(m_stat_packets + 1);
+					m_stat_bytes.release(m_stat_bytes + (job.type <= vector_copy ? job.length : 0));
+
+					pos += count;
+					m_processed_count.release(pos);
 				}
 
 				m_current_job = nullptr;
 
+				// Wake up producers waiting for space
+				m_processed_count.notify_all();
+
 				if (m_enqueued_count.load() == m_processed_count.load())
 				{
-					m_processed_count.notify_all();
 					std::this_thread::yield();
 				}
 			}
@@ -81,6 +130,76 @@ namespace rsx
 			m_processed_count.notify_all();
 		}
 
+		// Lock the ring once it has space for a packet and the payload, returns payload storage (nullptr if terminated)
+		u8* lock_put(u32 payload_size)
+		{
+			while (true)
+			{
+				m_put_mutex.lock();
+
+				const u64 processed = m_processed_count;
+
+				if (processed == umax)
+				{
+					// Offloader has been terminated
+					m_put_mutex.unlock();
+					return nullptr;
+				}
+
+				// Payload location in the arena, never wrapped around
+				m_arena_pos = m_arena_put;
+
+				if (payload_size && (m_arena_pos % s_arena_size) + payload_size > s_arena_size)
+				{
+					m_arena_pos += s_arena_size - (m_arena_pos % s_arena_size);
+				}
+
+				if (m_enqueued_count - processed < s_packet_count && m_arena_pos + payload_size - m_arena_get <= s_arena_size)
+				{
+					return m_arena.get() + (m_arena_pos % s_arena_size);
+				}
+
+				// Wait without holding the lock
+				m_put_mutex.unlock();
+
+				if (std::this_thread::get_id() == m_thread_id)
+				{
+					// Only this thread can make space
+					fmt::throw_exception("RSX offload ring overflow on the offloader thread");
+				}
+
+				if (auto rsxthr = get_current_renderer(); rsxthr && rsxthr->is_current_thread())
+				{
+					// Keep servicing RSX local tasks
+					rsxthr->on_semaphore_acquire_wait();
+					m_processed_count.wait(processed, atomic_wait_timeout{100'000});
+				}
+				else
+				{
+					m_processed_count.wait(processed);
+				}
+			}
+		}
+
+		// Publish the packet and unlock the ring (payload is located at the storage returned by lock_put)
+		void unlock_put(const transport_packet& packet)
+		{
+			const u64 pos = m_enqueued_count;
+
+			transport_packet& slot = m_packets[pos % s_packet_count];
+			slot = packet;
+
+			if (packet.type == vector_copy)
+			{
+				slot.src = m_arena.get() + (m_arena_pos % s_arena_size);
+				slot.arena_end = m_arena_pos + packet.length;
+				m_arena_put = slot.arena_end;
+			}
+
+			m_enqueued_count.release(pos + 1);
+			m_put_mutex.unlock();
+		}
+
 		static constexpr auto thread_name = "RSX Offloader"sv;
 	};
 
@@ -94,18 +213,35 @@ namespace rsx
 	{
 	}
 
+	void dma_manager::enqueue(const transport_packet& packet)
+	{
+		auto& _thr = g_fxo->get<dma_thread>();
+
+		if (_thr.lock_put(0))
+		{
+			_thr.unlock_put(packet);
+		}
+	}
+
 	// General transport
-	void dma_manager::copy(void *dst, std::vector<u8>& src, u32 length) const
+	void* dma_manager::reserve(u32 length) const
 	{
-		if (length <= max_immediate_transfer_size || !g_cfg.video.multithreaded_rsx)
+		if (length <= max_immediate_transfer_size || !g_cfg.video.multithreaded_rsx || length > offload_thread::s_arena_size / 4)
 		{
-			std::memcpy(dst, src.data(), length);
+			return nullptr;
 		}
-		else
+
+		return g_fxo->get<dma_thread>().lock_put(length);
+	}
+
+	void dma_manager::commit(void* dst, void* storage, u32 length) const
+	{
+		if (!storage)
 		{
-			g_fxo->get<dma_thread>().m_enqueued_count++;
-			g_fxo->get<dma_thread>().m_work_queue.push(dst, src, length);
+			return;
 		}
+
+		g_fxo->get<dma_thread>().unlock_put({dst, storage, length, 0});
 	}
 
 	void dma_manager::copy(void *dst, void *src, u32 length) const
@@ -116,8 +252,7 @@ namespace rsx
 		}
 		else
 		{
-			g_fxo->get<dma_thread>().m_enqueued_count++;
-			g_fxo->get<dma_thread>().m_work_queue.push(dst, src, length);
+			enqueue({dst, src, length});
 		}
 	}
 
@@ -131,8 +266,7 @@ namespace rsx
 		}
 		else
 		{
-			g_fxo->get<dma_thread>().m_enqueued_count++;
-			g_fxo->get<dma_thread>().m_work_queue.push(dst, primitive, count);
+			enqueue({dst, primitive, count});
 		}
 	}
 
@@ -141,8 +275,7 @@ namespace rsx
 	{
 		ensure(g_cfg.video.multithreaded_rsx);
 
-		g_fxo->get<dma_thread>().m_enqueued_count++;
-		g_fxo->get<dma_thread>().m_work_queue.push(request_code, args);
+		enqueue({request_code, args});
 	}
 
 	// Synchronization
@@ -230,4 +363,10 @@ namespace rsx
 
 		return utils::address_range::start_length(vm::get_addr(address), range);
 	}
+
+	std::pair<u64, u64> dma_manager::get_stats()
+	{
+		auto& _thr = g_fxo->get<dma_thread>();
+		return {_thr.m_stat_packets.load(), _thr.m_stat_bytes.load()};
+	}
 }
@@ -21,19 +21,23 @@ namespace rsx
 		struct transport_packet
 		{
 			op type{};
-			std::vector<u8> opt_storage{};
 			void* src{};
 			void* dst{};
 			u32 length{};
 			u32 aux_param0{};
 			u32 aux_param1{};
 
+			// Arena position released after processing (vector_copy only)
+			u64 arena_end{};
+
+			transport_packet() = default;
+
 			transport_packet(void *_dst, void *_src, u32 len)
 				: type(op::raw_copy), src(_src), dst(_dst), length(len)
 			{}
 
-			transport_packet(void *_dst, std::vector<u8>& _src, u32 len)
-				: type(op::vector_copy), opt_storage(std::move(_src)), dst(_dst), length(len)
+			transport_packet(void *_dst, void *_src, u32 len, u64 _arena_end)
+				: type(op::vector_copy), src(_src), dst(_dst), length(len), arena_end(_arena_end)
 			{}
 
 			transport_packet(void *_dst, rsx::primitive_type prim, u32 len)
@@ -50,6 +54,9 @@ namespace rsx
 		// TODO: Improved benchmarks here; value determined by profiling on a Ryzen CPU, rounded to the nearest 512 bytes
 		const u32 max_immediate_transfer_size = 3584;
 
+		// Push packet to the offload ring
+		static void enqueue(const transport_packet& packet);
+
 	public:
 		dma_manager() = default;
 
@@ -57,9 +64,13 @@ namespace rsx
 		void init();
 
 		// General tranport
-		void copy(void *dst, std::vector<u8>& src, u32 length) const;
 		void copy(void *dst, void *src, u32 length) const;
 
+		// Zero-copy transport: reserve offload storage for the data, fill it, then commit (on the same thread)
+		// If nullptr is returned, the data must be written to dst directly and commit is a no-op
+		void* reserve(u32 length) const;
+		void commit(void* dst, void* storage, u32 length) const;
+
 		// Vertex utilities
 		static void emulate_as_indexed(void *dst, rsx::primitive_type primitive, u32 count);
 
@@ -76,6 +87,9 @@ namespace rsx
 		// Fault recovery
 		static utils::address_range get_fault_range(bool writing);
 
+		// Statistics: processed packets (after merging) and bytes
+		static std::pair<u64, u64> get_stats();
+
 		struct offload_thread;
 	};
 }
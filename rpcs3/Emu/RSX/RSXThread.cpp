@@ -15,12 +15,12 @@
 #include "Emu/Cell/lv2/sys_event.h"
 #include "Emu/Cell/lv2/sys_time.h"
 #include "Emu/Cell/Modules/cellGcmSys.h"
+#include "Emu/perf_meter.hpp"
 #include "Overlays/overlay_perf_metrics.h"
 #include "Utilities/date_time.h"
 #include "Utilities/span.h"
 #include "Utilities/StrUtil.h"
 
-#include "util/cereal.hpp"
 #include "util/asm.hpp"
 
 #include <sstream>
@@ -2394,6 +2394,9 @@ namespace rsx
 		if (info.emu_flip)
 		{
 			performance_counters.sampled_frames++;
+			performance_counters.presented_frames++;
+
+			perf_stat_base::mark("FLIP");
 		}
 	}
 
@@ -2885,6 +2888,7 @@ namespace rsx
 		if (g_user_asked_for_frame_capture.exchange(false) && !capture_current_frame)
 		{
 			capture_current_frame = true;
+			capture_frames_left = static_cast<u32>(g_cfg.video.frame_capture_count);
 			frame_debug.reset();
 			frame_capture.reset();
 
@@ -2897,18 +2901,30 @@ namespace rsx
 			frame_capture.replay_commands.push_back(replay_cmd);
 			capture::capture_display_tile_state(this, frame_capture.replay_commands.back());
 		}
-		else if (capture_current_frame)
+		else if (capture_current_frame && --capture_frames_left == 0)
 		{
 			capture_current_frame = false;
 
-			const std::string file_path = fs::get_config_dir() + "captures/" + Emu.GetTitleID() + "_" + date_time::current_time_narrow() + "_capture.rrc";
+			// Memory pages are shared between draws and frames, so unchanged data is only stored once
+			usz referenced_size = 0;
+			usz stored_size = 0;
 
-			// todo: may want to compress this data?
-			const std::string file_data = cereal_serialize(frame_capture);
+			for (const auto& [hash, block] : frame_capture.memory_data_map)
+			{
+				referenced_size += block.size;
+			}
 
-			fs::pending_file temp(file_path);
+			for (const auto& [hash, page] : frame_capture.memory_page_map)
+			{
+				stored_size += page.size();
+			}
+
+			rsx_log.notice("Capture: %u frame(s), %u commands, %u memory blocks, %u unique pages (%u KiB stored, %u KiB referenced)",
+				g_cfg.video.frame_capture_count.get(), frame_capture.replay_commands.size(), frame_capture.memory_data_map.size(), frame_capture.memory_page_map.size(), stored_size / 1024, referenced_size / 1024);
+
+			const std::string file_path = fs::get_config_dir() + "captures/" + Emu.GetTitleID() + "_" + date_time::current_time_narrow() + "_capture.rrc";
 
-			if (temp.file && (temp.file.write(file_data), temp.commit(false)))
+			if (frame_capture_file::write(file_path, frame_capture))
 			{
 				rsx_log.success("Capture successful: %s", file_path);
 			}
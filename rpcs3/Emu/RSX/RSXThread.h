@@ -667,6 +667,7 @@ namespace rsx
 			FIFO_state state = FIFO_state::running;
 			u32 approximate_load = 0;
 			u32 sampled_frames = 0;
+			atomic_t<u32> presented_frames{ 0 }; // Total number of emulated flips
 		}
 		performance_counters;
 
@@ -763,6 +764,7 @@ namespace rsx
 		vm::ptr<void(u32)> vblank_handler = vm::null;
 		atomic_t<u64> vblank_count{0};
 		bool capture_current_frame = false;
+		u32 capture_frames_left = 0;
 
 	public:
 		atomic_t<bool> sync_point_request = false;
@@ -5,6 +5,8 @@
 #include "vkutils/device.h"
 #include "Emu/system_config.h"
 #include "../Common/GLSLCommon.h"
+#include "../Common/decompiled_program_cache.h"
+#include "Emu/IdManager.h"
 #include "../GCM.h"
 
 std::string VKFragmentDecompilerThread::getFloatTypeName(usz elementCount)
@@ -400,6 +402,45 @@ void VKFragmentProgram::Decompile(const RSXFragmentProgram& prog)
 	}
 
 	decompiler.device_props.emulate_depth_compare = !pdev->get_formats_support().d24_unorm_s8;
+
+	// Everything besides the program itself which affects the generated source
+	const struct
+	{
+		bool has_native_half_support;
+		bool emulate_depth_compare;
+		bool emulate_coverage_tests;
+		bool low_precision_tests;
+		vk::pipeline_binding_table binding_table;
+	}
+	env
+	{
+		decompiler.device_props.has_native_half_support,
+		decompiler.device_props.emulate_depth_compare,
+		g_cfg.video.antialiasing_level == msaa_level::none,
+		vk::get_driver_vendor() == vk::driver_vendor::NVIDIA,
+		vk::g_render_device->get_pipeline_binding_table()
+	};
+
+	const auto cache = g_fxo->try_get<rsx::decompiled_program_cache>();
+	const std::vector<u8> key = cache ? cache->get_key(prog, &env, sizeof(env)) : std::vector<u8>{};
+
+	if (rsx::decompiled_program cached; cache && cache->find(::glsl::glsl_fragment_program, key, cached))
+	{
+		for (const auto& input : cached.inputs)
+		{
+			vk::glsl::program_input& in = uniforms.emplace_back();
+			in.domain = static_cast<::glsl::program_domain>(input.domain);
+			in.type = static_cast<vk::glsl::program_input_type>(input.type);
+			in.location = input.location;
+			in.name = input.name;
+		}
+
+		FragmentConstantOffsetCache.assign(cached.constant_offsets.begin(), cached.constant_offsets.end());
+		output_color_masks = cached.output_color_masks;
+		shader.create(::glsl::program_domain::glsl_fragment_program, cached.source);
+		return;
+	}
+
 	decompiler.Task();
 
 	shader.create(::glsl::program_domain::glsl_fragment_program, source);
@@ -418,6 +459,21 @@ void VKFragmentProgram::Decompile(const RSXFragmentProgram& prog)
 			FragmentConstantOffsetCache.push_back(offset);
 		}
 	}
+
+	if (cache)
+	{
+		rsx::decompiled_program result;
+		result.source = std::move(source);
+		result.constant_offsets.assign(FragmentConstantOffsetCache.begin(), FragmentConstantOffsetCache.end());
+		result.output_color_masks = output_color_masks;
+
+		for (const auto& in : uniforms)
+		{
+			result.inputs.push_back({ static_cast<u32>(in.domain), static_cast<u32>(in.type), in.location, in.name });
+		}
+
+		cache->store(::glsl::glsl_fragment_program, key, result);
+	}
 }
 
 void VKFragmentProgram::Compile()
@@ -18,6 +18,7 @@
 #include "Emu/Memory/vm_locking.h"
 
 #include "../Common/program_state_cache2.hpp"
+#include "../Common/decompiled_program_cache.h"
 
 #include "util/asm.hpp"
 
@@ -492,7 +493,7 @@ VKGSRender::VKGSRender() : GSRender()
 		[this](const vk::pipeline_props& props, const RSXVertexProgram& vp, const RSXFragmentProgram& fp)
 		{
 			// Program was linked or queued for linking
-			m_shaders_cache->store(props, vp, fp);
+			m_shaders_cache->store(props, vp, fp, performance_counters.presented_frames);
 		}
 	);
 
@@ -504,6 +505,7 @@ VKGSRender::VKGSRender() : GSRender()
 	m_shaders_cache = std::make_unique<vk::shader_cache>(*m_prog_buffer, "vulkan", "v1.92");
 
 	g_fxo->init<vk::async_scheduler_thread>();
+	g_fxo->init<rsx::decompiled_program_cache>("vulkan", "v1");
 
 	open_command_buffer();
 
@@ -1053,6 +1055,8 @@ void VKGSRender::on_init_thread()
 
 void VKGSRender::on_exit()
 {
+	m_shaders_cache->abort_background_compile();
+
 	GSRender::on_exit();
 	zcull_ctrl.release();
 }
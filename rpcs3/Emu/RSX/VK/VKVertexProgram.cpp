@@ -5,6 +5,8 @@
 #include "VKHelpers.h"
 #include "vkutils/device.h"
 #include "../Common/GLSLCommon.h"
+#include "../Common/decompiled_program_cache.h"
+#include "Emu/IdManager.h"
 
 
 std::string VKVertexDecompilerThread::getFloatTypeName(usz elementCount)
@@ -327,11 +329,54 @@ VKVertexProgram::~VKVertexProgram()
 
 void VKVertexProgram::Decompile(const RSXVertexProgram& prog)
 {
+	// Everything besides the program itself which affects the generated source
+	const struct
+	{
+		bool emulate_conditional_rendering;
+		vk::pipeline_binding_table binding_table;
+	}
+	env
+	{
+		vk::emulate_conditional_rendering(),
+		vk::g_render_device->get_pipeline_binding_table()
+	};
+
+	const auto cache = g_fxo->try_get<rsx::decompiled_program_cache>();
+	const std::vector<u8> key = cache ? cache->get_key(prog, &env, sizeof(env)) : std::vector<u8>{};
+
+	if (rsx::decompiled_program cached; cache && cache->find(::glsl::glsl_vertex_program, key, cached))
+	{
+		for (const auto& input : cached.inputs)
+		{
+			vk::glsl::program_input& in = uniforms.emplace_back();
+			in.domain = static_cast<::glsl::program_domain>(input.domain);
+			in.type = static_cast<vk::glsl::program_input_type>(input.type);
+			in.location = input.location;
+			in.name = input.name;
+		}
+
+		shader.create(::glsl::program_domain::glsl_vertex_program, cached.source);
+		return;
+	}
+
 	std::string source;
 	VKVertexDecompilerThread decompiler(prog, source, parr, *this);
 	decompiler.Task();
 
 	shader.create(::glsl::program_domain::glsl_vertex_program, source);
+
+	if (cache)
+	{
+		rsx::decompiled_program result;
+		result.source = std::move(source);
+
+		for (const auto& in : uniforms)
+		{
+			result.inputs.push_back({ static_cast<u32>(in.domain), static_cast<u32>(in.type), in.location, in.name });
+		}
+
+		cache->store(::glsl::glsl_vertex_program, key, result);
+	}
 }
 
 void VKVertexProgram::Compile()
@@ -10,6 +10,9 @@
 #include "rsx_utils.h"
 #include <chrono>
 #include <unordered_map>
+#include <set>
+#include <array>
+#include <mutex>
 
 #include "util/vm.hpp"
 #include "util/sysinfo.hpp"
@@ -20,8 +23,6 @@ namespace rsx
 	template <typename pipeline_storage_type, typename backend_storage>
 	class shaders_cache
 	{
-		using unpacked_type = lf_fifo<std::tuple<pipeline_storage_type, RSXVertexProgram, RSXFragmentProgram>, 1000>; // TODO: Determine best size
-
 		struct pipeline_data
 		{
 			u64 vertex_program_hash;
@@ -51,60 +52,231 @@ namespace rsx
 			pipeline_storage_type pipeline_properties;
 		};
 
+		// Header of the pipeline index file
+		struct index_header
+		{
+			u64 magic;
+			u32 version;
+			u32 data_size; // sizeof(pipeline_data), depends on the backend
+		};
+
+		// Each record is followed by pipeline_data, the vertex program ucode and the fragment program ucode
+		struct record_header
+		{
+			u32 size;            // Total size of the record including this header
+			u32 first_use_frame; // Number of frames presented before the pipeline was first requested
+			u32 vp_size;
+			u32 fp_size;
+		};
+
+		struct cache_entry
+		{
+			u32 first_use_frame = 0;
+			pipeline_data data{};
+			std::vector<u32> vp_ucode;
+			std::unique_ptr<u8[]> fp_ucode;
+			u32 fp_size = 0;
+		};
+
+		using unpacked_type = std::tuple<pipeline_storage_type, RSXVertexProgram, RSXFragmentProgram>;
+
+		struct background_queue
+		{
+			std::vector<cache_entry> entries;
+			atomic_t<usz> pos = 0;
+		};
+
+		static constexpr u64 index_magic = "RSXPIPES"_u64;
+		static constexpr u32 index_version = 1;
+
 		std::string version_prefix;
 		std::string root_path;
 		std::string pipeline_class_name;
-		lf_fifo<std::unique_ptr<u8[]>, 100> fragment_program_data;
 
 		backend_storage& m_storage;
 
+		fs::file m_index;
+		std::mutex m_index_mutex;
+		std::set<std::array<u64, 4>> m_index_keys; // Entries already present in the index file
+
+		std::unique_ptr<named_thread_group<std::function<void()>>> m_background_workers;
+
 		static std::string get_message(u32 index, u32 processed, u32 entry_count)
 		{
 			return fmt::format("%s pipeline object %u of %u", index == 0 ? "Loading" : "Compiling", processed, entry_count);
 		}
 
-		void load_shaders(uint nb_workers, unpacked_type& unpacked, std::string& directory_path, std::vector<fs::dir_entry>& entries, u32 entry_count,
-		    shader_loading_dialog* dlg)
+		static std::array<u64, 4> get_key(const pipeline_data& data)
 		{
-			atomic_t<u32> processed(0);
+			u64 state_hash = 0;
+			state_hash ^= rpcs3::hash_base<u32>(data.vp_ctrl);
+			state_hash ^= rpcs3::hash_base<u32>(data.fp_ctrl);
+			state_hash ^= rpcs3::hash_base<u32>(data.vp_texture_dimensions);
+			state_hash ^= rpcs3::hash_base<u32>(data.fp_texture_dimensions);
+			state_hash ^= rpcs3::hash_base<u32>(data.fp_texcoord_control);
+			state_hash ^= rpcs3::hash_base<u16>(data.fp_unnormalized_coords);
+			state_hash ^= rpcs3::hash_base<u16>(data.fp_height);
+			state_hash ^= rpcs3::hash_base<u16>(data.fp_pixel_layout);
+			state_hash ^= rpcs3::hash_base<u16>(data.fp_lighting_flags);
+			state_hash ^= rpcs3::hash_base<u16>(data.fp_shadow_textures);
+			state_hash ^= rpcs3::hash_base<u16>(data.fp_redirected_textures);
 
-			std::function<void(u32)> shader_load_worker = [&](u32 stop_at)
+			return { data.vertex_program_hash, data.fragment_program_hash, data.pipeline_storage_hash, state_hash };
+		}
+
+		void append_record(const pipeline_data& data, u32 first_use_frame, const void* vp_ucode, u32 vp_size, const void* fp_ucode, u32 fp_size)
+		{
+			record_header header{};
+			header.size = static_cast<u32>(sizeof(record_header) + sizeof(pipeline_data)) + vp_size + fp_size;
+			header.first_use_frame = first_use_frame;
+			header.vp_size = vp_size;
+			header.fp_size = fp_size;
+
+			std::lock_guard lock(m_index_mutex);
+
+			if (!m_index || !m_index_keys.emplace(get_key(data)).second)
 			{
-				u32 pos;
-				// Processed is incremented before work starts in order to avoid two workers working on the same shader
-				while (((pos = processed++) < stop_at) && !Emu.IsStopped())
+				return;
+			}
+
+			// Write the whole record at once so that an interrupted write only leaves a truncated tail
+			std::vector<u8> record(header.size);
+			std::memcpy(record.data(), &header, sizeof(record_header));
+			std::memcpy(record.data() + sizeof(record_header), &data, sizeof(pipeline_data));
+			std::memcpy(record.data() + sizeof(record_header) + sizeof(pipeline_data), vp_ucode, vp_size);
+			std::memcpy(record.data() + sizeof(record_header) + sizeof(pipeline_data) + vp_size, fp_ucode, fp_size);
+
+			m_index.seek(0, fs::seek_end);
+			m_index.write(record.data(), record.size());
+		}
+
+		std::vector<cache_entry> read_index()
+		{
+			std::vector<cache_entry> result;
+
+			const std::vector<u8> buffer = m_index.to_vector<u8>();
+
+			index_header header{};
+
+			if (buffer.size() >= sizeof(index_header))
+			{
+				std::memcpy(&header, buffer.data(), sizeof(index_header));
+			}
+
+			if (header.magic != index_magic || header.version != index_version || header.data_size != sizeof(pipeline_data))
+			{
+				rsx_log.error("Discarding pipeline cache index since it's not binary compatible with the current shader cache");
+				m_index.trunc(0);
+				m_index.seek(0);
+				m_index.write(index_header{index_magic, index_version, sizeof(pipeline_data)});
+				return result;
+			}
+
+			usz pos = sizeof(index_header);
+
+			while (buffer.size() - pos >= sizeof(record_header))
+			{
+				record_header record;
+				std::memcpy(&record, buffer.data() + pos, sizeof(record_header));
+
+				const u64 expected_size = sizeof(record_header) + sizeof(pipeline_data) + u64{record.vp_size} + record.fp_size;
+
+				if (record.size != expected_size || record.size > buffer.size() - pos || !record.vp_size || record.vp_size % sizeof(u32) || !record.fp_size)
 				{
-					fs::dir_entry tmp = entries[pos];
+					break;
+				}
 
-					const auto filename = directory_path + "/" + tmp.name;
-					fs::file f(filename);
+				const u8* data = buffer.data() + pos + sizeof(record_header);
+				pos += record.size;
 
-					if (!f)
-					{
-						// Unexpected error, but avoid crash
-						continue;
-					}
+				cache_entry entry;
+				entry.first_use_frame = record.first_use_frame;
+				std::memcpy(&entry.data, data, sizeof(pipeline_data));
 
-					if (f.size() != sizeof(pipeline_data))
-					{
-						rsx_log.error("Removing cached pipeline object %s since it's not binary compatible with the current shader cache", tmp.name.c_str());
-						fs::remove_file(filename);
-						continue;
-					}
+				if (!m_index_keys.emplace(get_key(entry.data)).second)
+				{
+					continue;
+				}
 
-					pipeline_data pdata{};
-					f.read(&pdata, f.size());
+				entry.vp_ucode.resize(record.vp_size / sizeof(u32));
+				std::memcpy(entry.vp_ucode.data(), data + sizeof(pipeline_data), record.vp_size);
 
-					auto entry = unpack(pdata);
+				entry.fp_size = record.fp_size;
+				entry.fp_ucode = std::make_unique<u8[]>(record.fp_size);
+				std::memcpy(entry.fp_ucode.get(), data + sizeof(pipeline_data) + record.vp_size, record.fp_size);
 
-					if (std::get<1>(entry).data.empty() || !std::get<2>(entry).ucode_length)
-					{
-						continue;
-					}
+				result.emplace_back(std::move(entry));
+			}
 
-					m_storage.preload_programs(std::get<1>(entry), std::get<2>(entry));
+			if (pos != buffer.size())
+			{
+				// Most likely the process was terminated while a record was being written
+				rsx_log.warning("Pipeline cache index is truncated at offset 0x%x, dropping %u bytes", pos, buffer.size() - pos);
+				m_index.trunc(pos);
+			}
+
+			return result;
+		}
+
+		// Import entries written by older versions as one file per pipeline plus raw program files
+		std::vector<cache_entry> import_legacy_entries(const std::string& directory_path)
+		{
+			std::vector<cache_entry> result;
+
+			for (auto&& tmp : fs::dir(directory_path))
+			{
+				if (tmp.is_directory || tmp.size != sizeof(pipeline_data) || !tmp.name.ends_with(".bin"))
+				{
+					continue;
+				}
+
+				cache_entry entry;
+
+				if (fs::file f(directory_path + "/" + tmp.name); !f || !f.read(entry.data))
+				{
+					continue;
+				}
+
+				fs::file vp_file(fmt::format("%s/raw/%llX.vp", root_path, entry.data.vertex_program_hash));
+				fs::file fp_file(fmt::format("%s/raw/%llX.fp", root_path, entry.data.fragment_program_hash));
+
+				if (!vp_file || !fp_file || !vp_file.size() || vp_file.size() % sizeof(u32) || !fp_file.size())
+				{
+					continue;
+				}
+
+				vp_file.read(entry.vp_ucode, vp_file.size() / sizeof(u32));
+
+				entry.fp_size = ::size32(fp_file);
+				entry.fp_ucode = std::make_unique<u8[]>(entry.fp_size);
+				fp_file.read(entry.fp_ucode.get(), entry.fp_size);
 
-					unpacked[unpacked.push_begin()] = std::move(entry);
+				append_record(entry.data, 0, entry.vp_ucode.data(), ::size32(entry.vp_ucode) * sizeof(u32), entry.fp_ucode.get(), entry.fp_size);
+				result.emplace_back(std::move(entry));
+			}
+
+			if (!result.empty())
+			{
+				rsx_log.notice("Imported %u legacy pipeline cache entries", result.size());
+			}
+
+			return result;
+		}
+
+		void load_shaders(uint nb_workers, std::vector<unpacked_type>& unpacked, const std::vector<cache_entry>& entries, u32 entry_count, shader_loading_dialog* dlg)
+		{
+			atomic_t<u32> processed(0);
+
+			std::function<void(u32)> shader_load_worker = [&](u32 stop_at)
+			{
+				u32 pos;
+				// Processed is incremented before work starts in order to avoid two workers working on the same shader
+				while (((pos = processed++) < stop_at) && !Emu.IsStopped())
+				{
+					auto& entry = unpacked[pos];
+					entry = unpack(entries[pos]);
+
+					m_storage.preload_programs(std::get<1>(entry), std::get<2>(entry));
 				}
 				// Do not account for an extra shader that was never processed
 				processed--;
@@ -114,7 +286,7 @@ namespace rsx
 		}
 
 		template <typename... Args>
-		void compile_shaders(uint nb_workers, unpacked_type& unpacked, u32 entry_count, shader_loading_dialog* dlg, Args&&... args)
+		void compile_shaders(uint nb_workers, std::vector<unpacked_type>& unpacked, u32 entry_count, shader_loading_dialog* dlg, Args&&... args)
 		{
 			atomic_t<u32> processed(0);
 
@@ -134,6 +306,34 @@ namespace rsx
 			await_workers(nb_workers, 1, shader_comp_worker, processed, entry_count, dlg);
 		}
 
+		template <typename... Args>
+		void start_background_compile(std::vector<cache_entry>&& entries, usz start, Args... args)
+		{
+			auto queue = std::make_shared<background_queue>();
+			queue->entries = std::move(entries);
+			queue->pos = start;
+
+			// Leave half of the host threads to the emulator
+			const u32 nb_workers = std::max<u32>(utils::get_thread_count() / 2, 1);
+
+			rsx_log.notice("Compiling %u cached pipeline objects in the background", queue->entries.size() - start);
+
+			m_background_workers = std::make_unique<named_thread_group<std::function<void()>>>("RSX Precompiler ", nb_workers, std::function<void()>([this, queue, args...]()
+			{
+				for (usz pos; (pos = queue->pos++) < queue->entries.size();)
+				{
+					if (thread_ctrl::state() == thread_state::aborting || Emu.IsStopped())
+					{
+						break;
+					}
+
+					auto entry = unpack(queue->entries[pos]);
+					m_storage.preload_programs(std::get<1>(entry), std::get<2>(entry));
+					m_storage.add_pipeline_entry(std::get<1>(entry), std::get<2>(entry), std::get<0>(entry), args...);
+				}
+			}));
+		}
+
 		void await_workers(uint nb_workers, u8 step, std::function<void(u32)>& worker, atomic_t<u32>& processed, u32 entry_count, shader_loading_dialog* dlg)
 		{
 			if (nb_workers == 1)
@@ -211,150 +411,137 @@ namespace rsx
 				return;
 			}
 
-			std::string directory_path = root_path + "/pipelines/" + pipeline_class_name + "/" + version_prefix;
-
-			fs::dir root = fs::dir(directory_path);
+			const std::string directory_path = root_path + "/pipelines/" + pipeline_class_name + "/" + version_prefix;
 
-			if (!root)
+			if (!fs::is_dir(directory_path))
 			{
 				fs::create_path(directory_path);
-				fs::create_path(root_path + "/raw");
-				return;
 			}
 
-			std::vector<fs::dir_entry> entries;
+			const std::string index_path = directory_path + "/pipelines.bin";
+			const bool is_new_index = !fs::is_file(index_path);
 
-			for (auto&& tmp : root)
+			if (!m_index.open(index_path, fs::read + fs::write + fs::create))
 			{
-				if (tmp.is_directory)
-					continue;
-
-				entries.push_back(tmp);
+				rsx_log.error("Failed to open pipeline cache index %s (%s)", index_path, fs::g_tls_error);
+				return;
 			}
 
-			u32 entry_count = ::size32(entries);
+			std::vector<cache_entry> entries;
+
+			if (is_new_index)
+			{
+				m_index.write(index_header{index_magic, index_version, sizeof(pipeline_data)});
+				entries = import_legacy_entries(directory_path);
+			}
+			else
+			{
+				entries = read_index();
+			}
 
-			if (!entry_count)
+			if (entries.empty())
 				return;
 
-			root.rewind();
+			// Compile pipelines in the order in which the application first requested them
+			std::stable_sort(entries.begin(), entries.end(), [](const cache_entry& a, const cache_entry& b)
+			{
+				return a.first_use_frame < b.first_use_frame;
+			});
+
+			const uint nb_workers = g_cfg.video.renderer == video_renderer::vulkan ? utils::get_thread_count() : 1;
+
+			usz upfront_count = entries.size();
 
-			// Progress dialog
-			std::unique_ptr<shader_loading_dialog> fallback_dlg;
-			if (!dlg)
+			// Pipelines first used late in the session can be compiled after boot if the backend can compile off-thread
+			if (nb_workers > 1 && g_cfg.video.shader_background_precompile)
 			{
-				fallback_dlg = std::make_unique<shader_loading_dialog>();
-				dlg = fallback_dlg.get();
+				const u32 frame_limit = g_cfg.video.shader_precompile_frames;
+
+				upfront_count = std::partition_point(entries.begin(), entries.end(), [&](const cache_entry& entry)
+				{
+					return entry.first_use_frame < frame_limit;
+				}) - entries.begin();
 			}
 
-			dlg->create("Preloading cached shaders from disk.\nPlease wait...", "Shader Compilation");
-			dlg->set_limit(0, entry_count);
-			dlg->set_limit(1, entry_count);
-			dlg->update_msg(0, get_message(0, 0, entry_count));
-			dlg->update_msg(1, get_message(1, 0, entry_count));
+			if (const u32 entry_count = static_cast<u32>(upfront_count))
+			{
+				// Progress dialog
+				std::unique_ptr<shader_loading_dialog> fallback_dlg;
+				if (!dlg)
+				{
+					fallback_dlg = std::make_unique<shader_loading_dialog>();
+					dlg = fallback_dlg.get();
+				}
+
+				dlg->create("Preloading cached shaders from disk.\nPlease wait...", "Shader Compilation");
+				dlg->set_limit(0, entry_count);
+				dlg->set_limit(1, entry_count);
+				dlg->update_msg(0, get_message(0, 0, entry_count));
+				dlg->update_msg(1, get_message(1, 0, entry_count));
 
-			// Preload everything needed to compile the shaders
-			unpacked_type unpacked;
-			uint nb_workers = g_cfg.video.renderer == video_renderer::vulkan ? utils::get_thread_count() : 1;
+				// Preload everything needed to compile the shaders
+				std::vector<unpacked_type> unpacked(entry_count);
 
-			load_shaders(nb_workers, unpacked, directory_path, entries, entry_count, dlg);
+				load_shaders(nb_workers, unpacked, entries, entry_count, dlg);
 
-			// Account for any invalid entries
-			entry_count = unpacked.size();
+				compile_shaders(nb_workers, unpacked, entry_count, dlg, std::forward<Args>(args)...);
 
-			compile_shaders(nb_workers, unpacked, entry_count, dlg, std::forward<Args>(args)...);
+				dlg->refresh();
+				dlg->close();
+			}
 
-			dlg->refresh();
-			dlg->close();
+			if (upfront_count < entries.size() && !Emu.IsStopped())
+			{
+				start_background_compile(std::move(entries), upfront_count, args...);
+			}
 		}
 
-		void store(const pipeline_storage_type &pipeline, const RSXVertexProgram &vp, const RSXFragmentProgram &fp)
+		// Stop background compilation, must be called before the backend storage is destroyed
+		void abort_background_compile()
 		{
-			if (g_cfg.video.disable_on_disk_shader_cache)
+			if (!m_background_workers)
 			{
 				return;
 			}
 
-			if (vp.jump_table.size() > 32)
+			for (auto& worker : *m_background_workers)
 			{
-				rsx_log.error("shaders_cache: vertex program has more than 32 jump addresses. Entry not saved to cache");
-				return;
+				worker = thread_state::aborting;
 			}
 
-			pipeline_data data = pack(pipeline, vp, fp);
-
-			std::string fp_name = root_path + "/raw/" + fmt::format("%llX.fp", data.fragment_program_hash);
-			std::string vp_name = root_path + "/raw/" + fmt::format("%llX.vp", data.vertex_program_hash);
+			m_background_workers.reset();
+		}
 
-			// Writeback to cache either if file does not exist or it is invalid (unexpected size)
-			// Note: fs::write_file is not atomic, if the process is terminated in the middle an empty file is created
-			if (fs::stat_t s{}; !fs::stat(fp_name, s) || s.size != fp.ucode_length)
+		void store(const pipeline_storage_type &pipeline, const RSXVertexProgram &vp, const RSXFragmentProgram &fp, u32 frame)
+		{
+			if (g_cfg.video.disable_on_disk_shader_cache)
 			{
-				fs::write_file(fp_name, fs::rewrite, fp.get_data(), fp.ucode_length);
+				return;
 			}
 
-			if (fs::stat_t s{}; !fs::stat(vp_name, s) || s.size != vp.data.size() * sizeof(u32))
+			if (vp.jump_table.size() > 32)
 			{
-				fs::write_file(vp_name, fs::rewrite, vp.data);
+				rsx_log.error("shaders_cache: vertex program has more than 32 jump addresses. Entry not saved to cache");
+				return;
 			}
 
-			u64 state_hash = 0;
-			state_hash ^= rpcs3::hash_base<u32>(data.vp_ctrl);
-			state_hash ^= rpcs3::hash_base<u32>(data.fp_ctrl);
-			state_hash ^= rpcs3::hash_base<u32>(data.vp_texture_dimensions);
-			state_hash ^= rpcs3::hash_base<u32>(data.fp_texture_dimensions);
-			state_hash ^= rpcs3::hash_base<u32>(data.fp_texcoord_control);
-			state_hash ^= rpcs3::hash_base<u16>(data.fp_unnormalized_coords);
-			state_hash ^= rpcs3::hash_base<u16>(data.fp_height);
-			state_hash ^= rpcs3::hash_base<u16>(data.fp_pixel_layout);
-			state_hash ^= rpcs3::hash_base<u16>(data.fp_lighting_flags);
-			state_hash ^= rpcs3::hash_base<u16>(data.fp_shadow_textures);
-			state_hash ^= rpcs3::hash_base<u16>(data.fp_redirected_textures);
+			const pipeline_data data = pack(pipeline, vp, fp);
 
-			const std::string pipeline_file_name = fmt::format("%llX+%llX+%llX+%llX.bin", data.vertex_program_hash, data.fragment_program_hash, data.pipeline_storage_hash, state_hash);
-			const std::string pipeline_path = root_path + "/pipelines/" + pipeline_class_name + "/" + version_prefix + "/" + pipeline_file_name;
-			fs::write_file(pipeline_path, fs::rewrite, &data, sizeof(data));
+			append_record(data, frame, vp.data.data(), ::size32(vp.data) * sizeof(u32), fp.get_data(), fp.ucode_length);
 		}
 
-		RSXVertexProgram load_vp_raw(u64 program_hash) const
+		unpacked_type unpack(const cache_entry& entry)
 		{
-			RSXVertexProgram vp = {};
-
-			fs::file f(fmt::format("%s/raw/%llX.vp", root_path, program_hash));
-			if (f) f.read(vp.data, f.size() / sizeof(u32));
+			unpacked_type result;
+			auto& [pipeline, vp, fp] = result;
+			pipeline_data data = entry.data;
 
+			vp.data = entry.vp_ucode;
 			vp.skip_vertex_input_check = true;
 
-			return vp;
-		}
-
-		RSXFragmentProgram load_fp_raw(u64 program_hash)
-		{
-			fs::file f(fmt::format("%s/raw/%llX.fp", root_path, program_hash));
-
-			RSXFragmentProgram fp = {};
-
-			const u32 size = fp.ucode_length = f ? ::size32(f) : 0;
-
-			if (!size)
-			{
-				return fp;
-			}
-
-			auto buf = std::make_unique<u8[]>(size);
-			fp.data = buf.get();
-			f.read(buf.get(), size);
-			fragment_program_data[fragment_program_data.push_begin()] = std::move(buf);
-			return fp;
-		}
-
-		std::tuple<pipeline_storage_type, RSXVertexProgram, RSXFragmentProgram> unpack(pipeline_data &data)
-		{
-			std::tuple<pipeline_storage_type, RSXVertexProgram, RSXFragmentProgram> result;
-			auto& [pipeline, vp, fp] = result;
+			fp.data = entry.fp_ucode.get();
+			fp.ucode_length = entry.fp_size;
 
-			vp = load_vp_raw(data.vertex_program_hash);
-			fp = load_fp_raw(data.fragment_program_hash);
 			pipeline = data.pipeline_properties;
 
 			vp.output_mask = data.vp_ctrl;
@@ -32,7 +32,6 @@
 #include "util/sysinfo.hpp"
 #include "util/yaml.hpp"
 #include "util/logs.hpp"
-#include "util/cereal.hpp"
 
 #include <thread>
 #include <fstream>
@@ -93,6 +92,48 @@ namespace
 namespace atomic_wait
 {
 	extern void parse_hashtable(bool(*cb)(u64 id, u32 refs, u64 ptr, u32 stats));
+	extern void set_wait_stats(bool enable);
+	extern u64 parse_wait_stats(bool(*cb)(u64 ptr, u64 waits, u64 notifies, u64 rewaits, u64 spins, u64 wait_tsc));
+}
+
+static void report_atomic_wait_stats()
+{
+	if (!g_cfg.core.atomic_wait_stats)
+	{
+		return;
+	}
+
+	struct entry
+	{
+		u64 ptr, waits, notifies, rewaits, spins, wait_tsc;
+	};
+
+	static std::vector<entry> entries;
+
+	entries.clear();
+
+	const u64 lost = atomic_wait::parse_wait_stats([](u64 ptr, u64 waits, u64 notifies, u64 rewaits, u64 spins, u64 wait_tsc) -> bool
+	{
+		entries.push_back({ptr, waits, notifies, rewaits, spins, wait_tsc});
+		return false;
+	});
+
+	// Show the most waited on addresses
+	const usz count = std::min<usz>(entries.size(), 16);
+	std::partial_sort(entries.begin(), entries.begin() + count, entries.end(), [](const entry& a, const entry& b) { return a.waits > b.waits; });
+
+	const u64 tsc_freq = std::max<u64>(utils::get_tsc_freq(), 1);
+
+	std::string dump;
+
+	for (usz i = 0; i < count; i++)
+	{
+		const auto& e = entries[i];
+		fmt::append(dump, "\n\t0x%016x: waits=%u, notifies=%u, rewaits=%u, spins=%u, avg_wait=%.3fus", e.ptr, e.waits, e.notifies, e.rewaits, e.spins,
+			e.waits ? e.wait_tsc * 1'000'000. / tsc_freq / e.waits : 0.);
+	}
+
+	sys_log.notice("Atomic wait contention stats (%u addresses, %u events not recorded):%s", entries.size(), lost, dump);
 }
 
 template<>
@@ -605,26 +646,10 @@ std::string Emulator::PPUCache()
 
 bool Emulator::BootRsxCapture(const std::string& path)
 {
-	fs::file in_file(path);
-
-	if (!in_file)
-	{
-		return false;
-	}
-
-	std::unique_ptr<rsx::frame_capture_data> frame = std::make_unique<rsx::frame_capture_data>();
-	cereal_deserialize(*frame, in_file.to_string());
-	in_file.close();
-
-	if (frame->magic != rsx::FRAME_CAPTURE_MAGIC)
-	{
-		sys_log.error("Invalid rsx capture file!");
-		return false;
-	}
+	auto capture = std::make_unique<rsx::frame_capture_file>();
 
-	if (frame->version != rsx::FRAME_CAPTURE_VERSION)
+	if (!capture->open(path))
 	{
-		sys_log.error("Rsx capture file version not supported! Expected %d, found %d", rsx::FRAME_CAPTURE_VERSION, frame->version);
 		return false;
 	}
 
@@ -644,7 +669,7 @@ bool Emulator::BootRsxCapture(const std::string& path)
 	GetCallbacks().on_run(false);
 	m_state = system_state::running;
 
-	auto replay_thr = g_fxo->init<named_thread<rsx::rsx_replay_thread>>("RSX Replay"sv, std::move(frame));
+	auto replay_thr = g_fxo->init<named_thread<rsx::rsx_replay_thread>>("RSX Replay"sv, std::move(capture));
 	replay_thr->state -= cpu_flag::stop;
 	replay_thr->state.notify_one(cpu_flag::stop);
 
@@ -1834,6 +1859,8 @@ void Emulator::Run(bool start_playtime)
 
 	ConfigureLogs();
 
+	atomic_wait::set_wait_stats(g_cfg.core.atomic_wait_stats);
+
 	// Run main thread
 	idm::check<named_thread<ppu_thread>>(ppu_thread::id_base, [](named_thread<ppu_thread>& cpu)
 	{
@@ -1937,6 +1964,7 @@ void Emulator::Resume()
 	}
 
 	perf_stat_base::report();
+	report_atomic_wait_stats();
 
 	// Try to resume
 	if (!m_state.compare_and_swap_test(system_state::paused, system_state::running))
@@ -2034,6 +2062,8 @@ void Emulator::Stop(bool restart)
 	jit_runtime::finalize();
 
 	perf_stat_base::report();
+	report_atomic_wait_stats();
+	atomic_wait::set_wait_stats(false);
 
 	static u64 aw_refs = 0;
 	static u64 aw_colm = 0;
@@ -23,12 +23,35 @@ struct vfs_directory
 	std::vector<std::pair<std::string, vfs_directory>> dirs{};
 };
 
+// Resolved virtual directory, nodes are keyed by raw path fragments
+struct vfs_resolved_dir
+{
+	// Host path with trailing '/' (empty if not mounted)
+	std::string path{};
+
+	// Normalized virtual path with trailing '/'
+	std::string vpath{};
+
+	// Mount tree node (null if not in the tree)
+	const vfs_directory* node{};
+
+	// Appending a name doesn't give the resolved path (relative path, /host_root)
+	bool is_raw = false;
+
+	// Subdirectories (sorted by name)
+	std::vector<std::pair<std::string, vfs_resolved_dir>> dirs{};
+};
+
 struct vfs_manager
 {
 	shared_mutex mutex{};
 
 	// VFS root
 	vfs_directory root{};
+
+	// Cache of resolved directories, cleared on mount (root is resolved if cache_size != 0)
+	vfs_resolved_dir cache{};
+	u32 cache_size = 0;
 };
 
 bool vfs::mount(std::string_view vpath, std::string_view path)
@@ -42,6 +65,10 @@ bool vfs::mount(std::string_view vpath, std::string_view path)
 
 	std::lock_guard lock(table.mutex);
 
+	// Invalidate resolved paths
+	table.cache = {};
+	table.cache_size = 0;
+
 	if (vpath.empty())
 	{
 		// Empty relative path, should set relative path base; unsupported
@@ -109,12 +136,9 @@ bool vfs::mount(std::string_view vpath, std::string_view path)
 	}
 }
 
-std::string vfs::get(std::string_view vpath, std::vector<std::string>* out_dir, std::string* out_path)
+// Resolve path without using the cache, optionally fill cache node info
+static std::string get_path(const vfs_manager& table, std::string_view vpath, std::vector<std::string>* out_dir, std::string* out_path, vfs_resolved_dir* info = nullptr)
 {
-	auto& table = g_fxo->get<vfs_manager>();
-
-	reader_lock lock(table.mutex);
-
 	// Resulting path fragments: decoded ones
 	std::vector<std::string_view> result;
 	result.reserve(vpath.size() / 2);
@@ -144,11 +168,14 @@ std::string vfs::get(std::string_view vpath, std::vector<std::string>* out_dir,
 		if (pos == 0)
 		{
 			// Relative path: point to non-existent location
+			if (info) info->is_raw = true;
 			return fs::get_config_dir() + "delete_this_dir.../delete_this...";
 		}
 
 		if (pos == umax)
 		{
+			if (info) info->node = list.back();
+
 			// Absolute path: finalize
 			for (auto it = list.rbegin(), rend = list.rend(); it != rend; it++)
 			{
@@ -238,6 +265,8 @@ std::string vfs::get(std::string_view vpath, std::vector<std::string>* out_dir,
 
 				if (dir.second.path == "/"sv)
 				{
+					if (info) info->is_raw = true;
+
 					if (vpath.size() <= 1)
 					{
 						return fs::get_config_dir() + "delete_this_dir.../delete_this...";
@@ -281,6 +310,137 @@ std::string vfs::get(std::string_view vpath, std::vector<std::string>* out_dir,
 	return std::string{result_base} + fmt::merge(escaped, "/");
 }
 
+// Fill cache node for the directory vpath (must end with '/')
+static void resolve_dir(const vfs_manager& table, std::string_view vpath, vfs_resolved_dir& dir)
+{
+	dir.path = get_path(table, vpath, nullptr, &dir.vpath, &dir);
+
+	if (!dir.vpath.ends_with('/'))
+	{
+		dir.vpath += '/';
+	}
+}
+
+// Find cached directory by path (must start and end with '/'), doesn't allocate
+static const vfs_resolved_dir* find_cached_dir(const vfs_manager& table, std::string_view vpath)
+{
+	if (!table.cache_size)
+	{
+		return nullptr;
+	}
+
+	const vfs_resolved_dir* dir = &table.cache;
+
+	for (usz pos = vpath.find_first_not_of('/'); pos != umax; pos = vpath.find_first_not_of('/', pos))
+	{
+		const auto name = vpath.substr(pos, vpath.find_first_of('/', pos) - pos);
+		pos += name.size();
+
+		const auto found = std::lower_bound(dir->dirs.begin(), dir->dirs.end(), name, [](const auto& pair, std::string_view name) { return pair.first < name; });
+
+		if (found == dir->dirs.end() || found->first != name)
+		{
+			return nullptr;
+		}
+
+		dir = &found->second;
+	}
+
+	return dir;
+}
+
+// Add directory to the cache with all its parents (writer lock required)
+static const vfs_resolved_dir& add_cached_dir(vfs_manager& table, std::string_view vpath)
+{
+	if (table.cache_size >= 0x10000)
+	{
+		// Limit memory usage
+		table.cache = {};
+		table.cache_size = 0;
+	}
+
+	if (!table.cache_size)
+	{
+		resolve_dir(table, "/", table.cache);
+		table.cache_size = 1;
+	}
+
+	vfs_resolved_dir* dir = &table.cache;
+
+	for (usz pos = vpath.find_first_not_of('/'); pos != umax; pos = vpath.find_first_not_of('/', pos))
+	{
+		const auto name = vpath.substr(pos, vpath.find_first_of('/', pos) - pos);
+		pos += name.size();
+
+		auto found = std::lower_bound(dir->dirs.begin(), dir->dirs.end(), name, [](const auto& pair, std::string_view name) { return pair.first < name; });
+
+		if (found == dir->dirs.end() || found->first != name)
+		{
+			found = dir->dirs.emplace(found, name, vfs_resolved_dir{});
+			resolve_dir(table, std::string{vpath.substr(0, pos)} + '/', found->second);
+			table.cache_size++;
+		}
+
+		dir = &found->second;
+	}
+
+	return *dir;
+}
+
+std::string vfs::get(std::string_view vpath, std::vector<std::string>* out_dir, std::string* out_path)
+{
+	auto& table = g_fxo->get<vfs_manager>();
+
+	// Split the last path fragment, its directory is looked up in the cache
+	const usz name_pos = vpath.find_last_of('/') + 1;
+	const std::string_view name = vpath.substr(name_pos);
+
+	if (out_dir || !vpath.starts_with('/') || name.empty() || name == "." || name == "..")
+	{
+		reader_lock lock(table.mutex);
+
+		return get_path(table, vpath, out_dir, out_path);
+	}
+
+	const auto get_cached = [&](const vfs_resolved_dir& dir) -> std::string
+	{
+		if (dir.is_raw || (dir.node && std::any_of(dir.node->dirs.begin(), dir.node->dirs.end(), [&](const auto& pair) { return pair.first == name; })))
+		{
+			// Special directory or mount point
+			return get_path(table, vpath, nullptr, out_path);
+		}
+
+		if (dir.path.empty())
+		{
+			// Not mounted
+			return {};
+		}
+
+		if (out_path)
+		{
+			*out_path = dir.vpath;
+			*out_path += name;
+		}
+
+		return dir.path + vfs::escape(name);
+	};
+
+	const std::string_view dir_path = vpath.substr(0, name_pos);
+
+	{
+		reader_lock lock(table.mutex);
+
+		if (const auto dir = find_cached_dir(table, dir_path))
+		{
+			return get_cached(*dir);
+		}
+	}
+
+	std::lock_guard lock(table.mutex);
+
+	return get_cached(add_cached_dir(table, dir_path));
+}
+
 #if __cpp_char8_t >= 201811
 using char2 = char8_t;
 #else
@@ -3,6 +3,7 @@
 
 #include "util/sysinfo.hpp"
 #include "Utilities/Thread.h"
+#include "Utilities/File.h"
 
 #include <map>
 #include <mutex>
@@ -68,6 +69,91 @@ void perf_stat_base::print(const char* name) const noexcept
 	}
 }
 
+static shared_mutex s_perf_mutex;
+
+namespace
+{
+	struct perf_timeline_event
+	{
+		const char* name;
+		u64 start;
+		u64 end; // 0 for instant events
+	};
+
+	// Ring slot, may be read concurrently with its overwrite (the result is discarded then)
+	struct perf_timeline_slot
+	{
+		atomic_t<const char*> name;
+		atomic_t<u64> start;
+		atomic_t<u64> end;
+	};
+
+	// Ring buffer of the latest events of a thread, only written by its owner
+	struct perf_timeline_ring
+	{
+		static constexpr u64 capacity = 0x4000;
+
+		const std::string thread_name;
+		const u32 thread_id;
+		atomic_t<u64> head = 0;
+		atomic_t<bool> retired = false;
+		perf_timeline_slot events[capacity]{};
+
+		perf_timeline_ring(std::string name, u32 id) noexcept
+			: thread_name(std::move(name))
+			, thread_id(id)
+		{
+		}
+	};
+}
+
+static std::vector<std::shared_ptr<perf_timeline_ring>> s_perf_timeline;
+
+static thread_local struct perf_timeline_local
+{
+	std::shared_ptr<perf_timeline_ring> ring;
+
+	~perf_timeline_local()
+	{
+		if (ring)
+		{
+			ring->retired = true;
+		}
+	}
+} g_tls_perf_timeline;
+
+static void timeline_push(const char* name, u64 start_time, u64 end_time) noexcept
+{
+	auto& ring = g_tls_perf_timeline.ring;
+
+	if (!ring) [[unlikely]]
+	{
+		// Don't attempt to register some foreign/unnamed threads
+		if (!thread_ctrl::get_current())
+		{
+			return;
+		}
+
+		static atomic_t<u32> s_thread_id = 0;
+
+		ring = std::make_shared<perf_timeline_ring>(thread_ctrl::get_name(), ++s_thread_id);
+
+		std::lock_guard lock(s_perf_mutex);
+		s_perf_timeline.emplace_back(ring);
+	}
+
+	const u64 pos = ring->head.raw();
+
+	// Order previous head update before overwriting the slot (see dump_timeline)
+	std::atomic_thread_fence(std::memory_order_release);
+
+	auto& slot = ring->events[pos % perf_timeline_ring::capacity];
+	slot.name.release(name);
+	slot.start.release(start_time);
+	slot.end.release(end_time);
+	ring->head.release(pos + 1);
+}
+
 #ifdef _MSC_VER
 extern "C" void _mm_lfence();
 #endif
@@ -96,9 +182,12 @@ SAFE_BUFFERS(void) perf_stat_base::push(u64 data[66], u64 start_time, const char
 	data[0] += ns != 0;
 	data[64 - std::countl_zero(ns)]++;
 	data[65] += ns;
-}
 
-static shared_mutex s_perf_mutex;
+	if (g_cfg.core.perf_timeline) [[unlikely]]
+	{
+		timeline_push(name, start_time, end_time);
+	}
+}
 
 static std::map<std::string, perf_stat_base> s_perf_acc;
 
@@ -142,21 +231,155 @@ void perf_stat_base::remove(u64 ns[66], const char* name) noexcept
 
 void perf_stat_base::report() noexcept
 {
-	std::lock_guard lock(s_perf_mutex);
+	{
+		std::lock_guard lock(s_perf_mutex);
+
+		perf_log.notice("Performance report begin (%u src, %u acc):", s_perf_sources.size(), s_perf_acc.size());
+
+		for (auto& [name, ns] : s_perf_sources)
+		{
+			s_perf_acc[name].push(ns);
+		}
+
+		for (auto& [name, data] : s_perf_acc)
+		{
+			data.print(name.c_str());
+		}
+
+		s_perf_acc.clear();
+
+		perf_log.notice("Performance report end.");
+	}
+
+	if (g_cfg.core.perf_timeline)
+	{
+		dump_timeline();
+	}
+}
+
+void perf_stat_base::mark(const char* name) noexcept
+{
+	if (g_cfg.core.perf_report && g_cfg.core.perf_timeline) [[unlikely]]
+	{
+		timeline_push(name, get_tsc(), 0);
+	}
+}
+
+static void append_json_string(std::string& out, std::string_view str)
+{
+	out += '"';
+
+	for (char c : str)
+	{
+		if (c == '"' || c == '\\')
+		{
+			out += '\\';
+			out += c;
+		}
+		else if (static_cast<u8>(c) < 0x20)
+		{
+			fmt::append(out, "\\u%04x", static_cast<u8>(c));
+		}
+		else
+		{
+			out += c;
+		}
+	}
+
+	out += '"';
+}
+
+void perf_stat_base::dump_timeline() noexcept
+{
+	std::vector<std::shared_ptr<perf_timeline_ring>> rings;
+	{
+		std::lock_guard lock(s_perf_mutex);
+		rings = s_perf_timeline;
+
+		// Forget exited threads, their events are written one last time
+		std::erase_if(s_perf_timeline, [](const auto& ring) { return !!ring->retired; });
+	}
+
+	if (rings.empty())
+	{
+		return;
+	}
+
+	std::string out = "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+	bool first = true;
 
-	perf_log.notice("Performance report begin (%u src, %u acc):", s_perf_sources.size(), s_perf_acc.size());
+	const f64 freq = utils::get_tsc_freq() / 1000'000.;
+	u64 base = -1;
 
-	for (auto& [name, ns] : s_perf_sources)
+	// Snapshot each ring, dropping entries which could have been overwritten meanwhile
+	std::vector<std::vector<perf_timeline_event>> snapshots(rings.size());
+
+	for (usz i = 0; i < rings.size(); i++)
 	{
-		s_perf_acc[name].push(ns);
+		auto& ring = *rings[i];
+		const u64 head = ring.head.load();
+		const u64 begin = head > perf_timeline_ring::capacity ? head - perf_timeline_ring::capacity : 0;
+
+		for (u64 pos = begin; pos < head; pos++)
+		{
+			const auto& slot = ring.events[pos % perf_timeline_ring::capacity];
+			snapshots[i].push_back({slot.name.observe(), slot.start.observe(), slot.end.observe()});
+		}
+
+		std::atomic_thread_fence(std::memory_order_acquire);
+
+		// The slot of the event at (new_head - capacity) may be being overwritten by the event at new_head
+		const u64 new_head = ring.head.load();
+		const u64 valid = new_head >= perf_timeline_ring::capacity ? new_head - perf_timeline_ring::capacity + 1 : 0;
+
+		if (valid > begin)
+		{
+			snapshots[i].erase(snapshots[i].begin(), snapshots[i].begin() + std::min<u64>(valid - begin, snapshots[i].size()));
+		}
+
+		for (const auto& ev : snapshots[i])
+		{
+			base = std::min(base, ev.start);
+		}
 	}
 
-	for (auto& [name, data] : s_perf_acc)
+	for (usz i = 0; i < rings.size(); i++)
 	{
-		data.print(name.c_str());
+		const auto& ring = *rings[i];
+
+		// Thread name metadata
+		fmt::append(out, "%s{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":", first ? "" : ",", ring.thread_id);
+		append_json_string(out, ring.thread_name);
+		out += "}}";
+		first = false;
+
+		// Nesting is implied by the time ranges of complete events on the same thread
+		for (const auto& ev : snapshots[i])
+		{
+			out += ",{\"name\":";
+			append_json_string(out, ev.name);
+
+			if (ev.end)
+			{
+				fmt::append(out, ",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%u}", (ev.start - base) / freq, (ev.end - ev.start) / freq, ring.thread_id);
+			}
+			else
+			{
+				fmt::append(out, ",\"ph\":\"i\",\"s\":\"g\",\"ts\":%.3f,\"pid\":1,\"tid\":%u}", (ev.start - base) / freq, ring.thread_id);
+			}
+		}
 	}
 
-	s_perf_acc.clear();
+	out += "]}\n";
 
-	perf_log.notice("Performance report end.");
+	const std::string path = fs::get_cache_dir() + "perf_timeline.json";
+
+	if (fs::file file{path, fs::rewrite}; file && file.write(out.data(), out.size()) == out.size())
+	{
+		perf_log.notice("Performance timeline written to %s (%u threads)", path, rings.size());
+	}
+	else
+	{
+		perf_log.error("Failed to write performance timeline to %s (%s)", path, fs::g_tls_error);
+	}
 }
@@ -63,6 +63,12 @@ public:
 
 	// Collect all data, report it, and clean
 	static void report() noexcept;
+
+	// Record an instant event (such as a frame flip) on the timeline
+	static void mark(const char* name) noexcept;
+
+	// Write recorded timeline events in Chrome trace format (also done by report())
+	static void dump_timeline() noexcept;
 };
 
 // Object that prints event length stats at the end
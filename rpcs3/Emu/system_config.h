@@ -22,11 +22,14 @@ struct cfg_root : cfg::node
 		cfg::_enum<ppu_decoder_type> ppu_decoder{ this, "PPU Decoder", ppu_decoder_type::llvm };
 		cfg::_int<1, 8> ppu_threads{ this, "PPU Threads", 2 }; // Amount of PPU threads running simultaneously (must be 2)
 		cfg::_bool ppu_debug{ this, "PPU Debug" };
+		cfg::_bool ppu_trace_interpreter{ this, "PPU Trace Interpreter", false }; // Interpreter only: dispatch pre-decoded straight-line runs
 		cfg::_bool llvm_logs{ this, "Save LLVM logs" };
 		cfg::string llvm_cpu{ this, "Use LLVM CPU" };
 		cfg::_int<0, INT32_MAX> llvm_threads{ this, "Max LLVM Compile Threads", 0 };
+		cfg::_int<0, INT32_MAX> llvm_memory_limit{ this, "Max LLVM Compile Memory (MB)", 0 }; // Estimated, 0 = unlimited
 		cfg::_bool ppu_llvm_greedy_mode{ this, "PPU LLVM Greedy Mode", false, false };
 		cfg::_bool ppu_llvm_precompilation{ this, "PPU LLVM Precompilation", true };
+		cfg::_bool ppu_analysis_cache{ this, "PPU Analysis Cache", true };
 		cfg::_enum<thread_scheduler_mode> thread_scheduler{this, "Thread Scheduler Mode", thread_scheduler_mode::os};
 		cfg::_bool set_daz_and_ftz{ this, "Set DAZ and FTZ", false };
 		cfg::_enum<spu_decoder_type> spu_decoder{ this, "SPU Decoder", spu_decoder_type::llvm };
@@ -74,6 +77,8 @@ struct cfg_root : cfg::node
 
 		cfg::uint64 perf_report_threshold{this, "Performance Report Threshold", 500, true}; // In µs, 0.5ms = default, 0 = everything
 		cfg::_bool perf_report{this, "Enable Performance Report", false, true}; // Show certain perf-related logs
+		cfg::_bool perf_timeline{this, "Enable Performance Timeline", false, true}; // Record perf events per thread and dump them as Chrome trace JSON
+		cfg::_bool atomic_wait_stats{this, "Enable Atomic Wait Statistics", false, true}; // Log the most contended atomic wait addresses on resume and stop
 	} core{ this };
 
 	struct node_vfs : cfg::node
@@ -98,6 +103,8 @@ struct cfg_root : cfg::node
 		cfg::_bool host_root{ this, "Enable /host_root/" };
 		cfg::_bool init_dirs{ this, "Initialize Directories", true };
 
+		cfg::_bool fs_readahead{ this, "Enable File Read-Ahead", true }; // Prefetch sequentially read files on read-only mounts (e.g. /dev_bdvd) in background
+
 		cfg::_bool limit_cache_size{ this, "Limit disk cache size", false };
 		cfg::_int<0, 10240> cache_max_size{ this, "Disk cache maximum size (MB)", 5120 };
 
@@ -134,11 +141,13 @@ struct cfg_root : cfg::node
 		cfg::_bool frame_skip_enabled{ this, "Enable Frame Skip", false, true };
 		cfg::_bool force_cpu_blit_processing{ this, "Force CPU Blit", false, true }; // Debugging option
 		cfg::_bool disable_on_disk_shader_cache{ this, "Disable On-Disk Shader Cache", false };
+		cfg::_bool shader_background_precompile{ this, "Background Shader Precompilation", false }; // Vulkan only
 		cfg::_bool disable_vulkan_mem_allocator{ this, "Disable Vulkan Memory Allocator", false };
 		cfg::_bool full_rgb_range_output{ this, "Use full RGB output range", true, true }; // Video out dynamic range
 		cfg::_bool strict_texture_flushing{ this, "Strict Texture Flushing", false };
 		cfg::_bool disable_native_float16{ this, "Disable native float16 support", false };
 		cfg::_bool multithreaded_rsx{ this, "Multithreaded RSX", false };
+		cfg::_bool null_dma_benchmark{ this, "Null Renderer DMA Benchmark", false }; // Debugging option
 		cfg::_bool relaxed_zcull_sync{ this, "Relaxed ZCULL Sync", false };
 		cfg::_bool enable_3d{ this, "Enable 3D", false };
 		cfg::_bool debug_program_analyser{ this, "Debug Program Analyser", false };
@@ -149,8 +158,12 @@ struct cfg_root : cfg::node
 		cfg::_int<-16, 16> texture_lod_bias{ this, "Texture LOD Bias Addend", 0, true };
 		cfg::_int<1, 1024> min_scalable_dimension{ this, "Minimum Scalable Dimension", 16 };
 		cfg::_int<0, 16> shader_compiler_threads_count{ this, "Shader Compiler Threads", 0 };
+		cfg::uint<0, 100000> shader_precompile_frames{ this, "Shader Precompile Frames", 300 }; // Cached pipelines first used later are compiled in the background
+		cfg::_int<0, 16> vdec_threads{ this, "Video Decoder Threads", 0 }; // 0 = auto
+		cfg::_bool vdec_frame_threading{ this, "Video Decoder Frame Threading", false }; // Adds decoding latency of several pictures
 		cfg::_int<0, 30000000> driver_recovery_timeout{ this, "Driver Recovery Timeout", 1000000, true };
 		cfg::_int<0, 16667> driver_wakeup_delay{ this, "Driver Wake-Up Delay", 1, true };
+		cfg::_int<1, 600> frame_capture_count{ this, "Frame Capture Count", 1, true }; // Consecutive frames recorded into one RSX capture
 		cfg::_int<1, 1800> vblank_rate{ this, "Vblank Rate", 60, true }; // Changing this from 60 may affect game speed in unexpected ways
 		cfg::_bool decr_memory_layout{ this, "DECR memory layout", false}; // Force enable increased allowed main memory range as DECR console
 
@@ -35,6 +35,7 @@ namespace utils
 
 #include "asm.hpp"
 #include "endian.hpp"
+#include "sysinfo.hpp"
 
 // Total number of entries.
 static constexpr usz s_hashtable_size = 1u << 17;
@@ -804,6 +805,81 @@ namespace
 	};
 }
 
+namespace
+{
+	// Optional contention statistics of a single address
+	struct wait_stats
+	{
+		atomic_t<u64> iptr; // Address (0 if the entry is free)
+		atomic_t<u64> waits;
+		atomic_t<u64> notifies;
+		atomic_t<u64> rewaits; // Returned from sleeping with the value unchanged and slept again
+		atomic_t<u64> spins; // Waits completed by spinning
+		atomic_t<u64> wait_tsc; // Total wait time
+	};
+}
+
+// Number of addresses which statistics can be kept for
+static constexpr usz s_wait_stats_size = 1u << 13;
+
+static atomic_t<bool> s_stats_enabled{false};
+
+// Allocated when statistics are enabled for the first time, never freed (waiters may still use it)
+static atomic_t<wait_stats*> s_wait_stats{};
+
+// Events on addresses which didn't fit in the table
+static atomic_t<u64> s_wait_stats_lost{};
+
+// Find statistics entry of the address, optionally allocate a new one
+static wait_stats* get_wait_stats(uptr iptr, bool add)
+{
+	const auto table = s_wait_stats.load();
+
+	if (!table)
+	{
+		return nullptr;
+	}
+
+	// Linear probing from the address hash
+	const usz start = static_cast<usz>((iptr * 0x9e3779b97f4a7c15) >> (64 - 13));
+
+	for (usz i = 0; i < 16; i++)
+	{
+		auto& stats = table[(start + i) % s_wait_stats_size];
+
+		if (const u64 old = stats.iptr; old == iptr)
+		{
+			return &stats;
+		}
+		else if (old)
+		{
+			continue;
+		}
+
+		if (!add)
+		{
+			return nullptr;
+		}
+
+		if (stats.iptr.compare_and_swap_test(0, iptr) || stats.iptr == iptr)
+		{
+			return &stats;
+		}
+	}
+
+	s_wait_stats_lost++;
+	return nullptr;
+}
+
+// Spin budget (in pause iterations) learned for each hashtable slot
+static atomic_t<u16> s_spin_budget[s_hashtable_size]{};
+
+static constexpr u16 s_spin_min = 32;
+static constexpr u16 s_spin_max = 1024;
+
+// Waits shorter than this (in TSC ticks) are considered worth spinning for
+static constexpr u64 s_spin_short_tsc = 30'000;
+
 #ifdef _MSC_VER
 extern "C" u64 __rdtsc();
 #endif
@@ -998,6 +1074,37 @@ SAFE_BUFFERS(void) atomic_wait_engine::wait(const void* data, u32 size, u128 old
 
 	const uptr iptr = reinterpret_cast<uptr>(data) & (~s_ref_mask >> 17);
 
+	const u32 stat_id = hash_engine(iptr).id;
+
+	// Spinning is only useful if another thread can change the value meanwhile
+	static const bool s_can_spin = utils::get_thread_count() > 1;
+
+	const u16 spin_budget = timeout == umax && s_can_spin ? s_spin_budget[stat_id].load() : 0;
+
+	for (u32 i = 0; i < spin_budget; i++)
+	{
+		utils::pause();
+
+		if (!ptr_cmp(data, size, old_value, mask, ext))
+		{
+			// Short wait, keep spinning on this slot
+			s_spin_budget[stat_id].release(std::min<u16>(spin_budget + spin_budget / 2, s_spin_max));
+
+			if (s_stats_enabled) [[unlikely]]
+			{
+				if (const auto stats = get_wait_stats(iptr, true))
+				{
+					stats->waits++;
+					stats->spins++;
+					stats->wait_tsc += utils::get_tsc() - stamp0;
+				}
+			}
+
+			s_tls_wait_cb(data, -1, stamp0);
+			return;
+		}
+	}
+
 	uint ext_size = 0;
 
 	uptr iptr_ext[atomic_wait::max_list - 1]{};
@@ -1097,9 +1204,15 @@ SAFE_BUFFERS(void) atomic_wait_engine::wait(const void* data, u32 size, u128 old
 #endif
 
 	u64 attempts = 0;
+	u64 rewaits = 0;
 
 	while (ptr_cmp(data, size, old_value, mask, ext))
 	{
+		if (attempts)
+		{
+			rewaits++;
+		}
+
 #ifdef USE_FUTEX
 		struct timespec ts;
 		ts.tv_sec  = timeout / 1'000'000'000;
@@ -1238,6 +1351,24 @@ SAFE_BUFFERS(void) atomic_wait_engine::wait(const void* data, u32 size, u128 old
 
 	root_info::slot_free(iptr, slot, 0);
 
+	const u64 wait_tsc = utils::get_tsc() - stamp0;
+
+	if (timeout == umax && s_can_spin)
+	{
+		// Learn the spin budget: grow after short waits, shrink after long ones
+		s_spin_budget[stat_id].release(wait_tsc < s_spin_short_tsc ? std::clamp<u16>(spin_budget * 2, s_spin_min, s_spin_max) : spin_budget / 2);
+	}
+
+	if (s_stats_enabled) [[unlikely]]
+	{
+		if (const auto stats = get_wait_stats(iptr, true))
+		{
+			stats->waits++;
+			stats->rewaits += rewaits;
+			stats->wait_tsc += wait_tsc;
+		}
+	}
+
 	s_tls_wait_cb(data, -1, stamp0);
 }
 
@@ -1314,6 +1445,14 @@ void atomic_wait_engine::notify_one(const void* data, u32 size, u128 mask)
 {
 	const uptr iptr = reinterpret_cast<uptr>(data) & (~s_ref_mask >> 17);
 
+	if (s_stats_enabled) [[unlikely]]
+	{
+		if (const auto stats = get_wait_stats(iptr, false))
+		{
+			stats->notifies++;
+		}
+	}
+
 	if (s_tls_notify_cb)
 		s_tls_notify_cb(data, 0);
 
@@ -1339,6 +1478,14 @@ SAFE_BUFFERS(void) atomic_wait_engine::notify_all(const void* data, u32 size, u1
 {
 	const uptr iptr = reinterpret_cast<uptr>(data) & (~s_ref_mask >> 17);
 
+	if (s_stats_enabled) [[unlikely]]
+	{
+		if (const auto stats = get_wait_stats(iptr, false))
+		{
+			stats->notifies++;
+		}
+	}
+
 	if (s_tls_notify_cb)
 		s_tls_notify_cb(data, 0);
 
@@ -1431,4 +1578,58 @@ namespace atomic_wait
 			}
 		}
 	}
+
+	extern void set_wait_stats(bool enable)
+	{
+		if (enable && !s_stats_enabled.exchange(true))
+		{
+			if (const auto table = s_wait_stats.load())
+			{
+				// Start from scratch
+				for (usz i = 0; i < s_wait_stats_size; i++)
+				{
+					auto& stats = table[i];
+					stats.iptr.release(0);
+					stats.waits.release(0);
+					stats.notifies.release(0);
+					stats.rewaits.release(0);
+					stats.spins.release(0);
+					stats.wait_tsc.release(0);
+				}
+			}
+			else
+			{
+				s_wait_stats.release(new wait_stats[s_wait_stats_size]{});
+			}
+
+			s_wait_stats_lost.release(0);
+		}
+		else if (!enable)
+		{
+			s_stats_enabled.release(false);
+		}
+	}
+
+	extern u64 parse_wait_stats(bool(*cb)(u64 ptr, u64 waits, u64 notifies, u64 rewaits, u64 spins, u64 wait_tsc))
+	{
+		const auto table = s_wait_stats.load();
+
+		for (usz i = 0; table && i < s_wait_stats_size; i++)
+		{
+			const auto& stats = table[i];
+
+			if (!stats.iptr || (!stats.waits && !stats.notifies))
+			{
+				continue;
+			}
+
+			if (cb(stats.iptr, stats.waits, stats.notifies, stats.rewaits, stats.spins, stats.wait_tsc))
+			{
+				break;
+			}
+		}
+
+		// Return the number of events which couldn't be recorded
+		return s_wait_stats_lost;
+	}
 }
@@ -3,6 +3,11 @@
 #include "util/types.hpp"
 #include "util/atomic.hpp"
 
+namespace fs
+{
+	class file;
+}
+
 namespace utils
 {
 	// Memory protection type
@@ -105,4 +110,30 @@ namespace utils
 		// Another userdata
 		u64 info = 0;
 	};
+
+	// Read-only mapping of a whole file, get() returns nullptr on failure
+	class file_view
+	{
+		u8* m_ptr{};
+		u64 m_size{};
+
+	public:
+		explicit file_view(const fs::file& file);
+
+		file_view(const file_view&) = delete;
+
+		file_view& operator=(const file_view&) = delete;
+
+		~file_view();
+
+		const u8* get() const
+		{
+			return m_ptr;
+		}
+
+		u64 size() const
+		{
+			return m_size;
+		}
+	};
 }
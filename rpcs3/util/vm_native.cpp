@@ -496,4 +496,47 @@ namespace utils
 			this->unmap(ptr);
 		}
 	}
+
+	file_view::file_view(const fs::file& file)
+		: m_size(file ? file.size() : 0)
+	{
+		if (!m_size)
+		{
+			return;
+		}
+
+#ifdef _WIN32
+		const HANDLE mapping = ::CreateFileMappingW(file.get_handle(), nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+		if (!mapping)
+		{
+			return;
+		}
+
+		// The view keeps the mapping object alive
+		m_ptr = static_cast<u8*>(::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+		::CloseHandle(mapping);
+#else
+		const auto result = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, file.get_handle(), 0);
+
+		if (result != reinterpret_cast<void*>(UINT64_MAX))
+		{
+			m_ptr = static_cast<u8*>(result);
+		}
+#endif
+	}
+
+	file_view::~file_view()
+	{
+		if (!m_ptr)
+		{
+			return;
+		}
+
+#ifdef _WIN32
+		::UnmapViewOfFile(m_ptr);
+#else
+		::munmap(m_ptr, m_size);
+#endif
+	}
 }